@@ -37,6 +37,11 @@
 #define ANIMATION_DESCRIPTION_LIST_CAPACITY 40
 #define ANIMATION_SAD_LIST_CAPACITY 16
 
+#define PATH_CACHE_CAPACITY 32
+
+#define PATH_CACHE_CHECK_DESTINATION 0x01
+#define PATH_CACHE_NOT_IN_COMBAT 0x02
+
 #define ANIMATION_SEQUENCE_FORCED 0x01
 
 typedef enum AnimationKind {
@@ -216,6 +221,22 @@ typedef struct AnimationSequence {
 
 static_assert(sizeof(AnimationSequence) == 0x790, "wrong size");
 
+typedef struct PathCacheEntry {
+    // Pooled objects are reused as soon as they are destroyed, so the
+    // pointer alone does not identify the object, see [make_path].
+    Object* object;
+    int objectId;
+    int objectPid;
+    int from;
+    int to;
+    int elevation;
+    unsigned int epoch;
+    int flags;
+    // Path length or -1 if entry is not used.
+    int length;
+    unsigned char rotations[800];
+} PathCacheEntry;
+
 typedef struct PathNode {
     int tile;
     int from;
@@ -270,6 +291,16 @@ static int anim_animate(Object* obj, int anim, int animationSequenceIndex, int f
 static void object_anim_compact();
 static int anim_turn_towards(Object* obj, int delta, int animationSequenceIndex);
 static int check_gravity(int tile, int elevation);
+static void path_seen_begin();
+static bool path_seen_test(int tile);
+static void path_seen_mark(int tile);
+static int path_child_alloc();
+static void path_child_free(int slot);
+static bool path_open_less(int slot1, int slot2);
+static void path_open_push(int slot);
+static int path_open_pop();
+static void path_cache_clear();
+static bool straight_path_tile_clear(PathBuilderCallback* callback, int a6, int tile, int elevation);
 
 // 0x4FEA98
 static int curr_sad = 0;
@@ -295,15 +326,57 @@ static PathNode dad[2000];
 // 0x560314
 static AnimationSequence anim_set[ANIMATION_SEQUENCE_LIST_CAPACITY];
 
+// Generation stamp of visited tiles, see [seen_generation].
+//
 // 0x56A1E4
-static unsigned char seen[5000];
+static unsigned int seen[HEX_GRID_SIZE];
 
 // 0x54CA94
 static PathNode child[2000];
 
+// Current generation of [seen] table.
+static unsigned int seen_generation;
+
+// Index of tile's node in [dad] array, only valid for tiles closed during
+// current pathfinding.
+static short dad_index[HEX_GRID_SIZE];
+
+// Binary heap of [child] slots ordered by estimated path cost.
+static int open_heap[2000];
+
+// Number of slots in [open_heap].
+static int open_length;
+
+// Binary heap of released [child] slots.
+static int free_child[2000];
+
+// Number of slots in [free_child] heap.
+static int free_child_length;
+
+// Number of [child] slots handed out at least once during current
+// pathfinding.
+static int child_used;
+
 // 0x56B56C
 static int curr_anim_counter;
 
+// Results of recent [make_path] calls.
+static PathCacheEntry path_cache[PATH_CACHE_CAPACITY];
+
+// Index of next [path_cache] entry to be replaced.
+static int path_cache_next;
+
+static int path_cache_hits;
+
+static int path_cache_misses;
+
+// Number of nodes closed by [make_path_func], proportional to time it spends
+// in the open list.
+static int path_nodes_expanded;
+
+// Milliseconds spent in [make_path_func] on [path_cache] misses.
+static unsigned int path_search_time;
+
 // 0x4134B0
 void anim_init()
 {
@@ -329,6 +402,8 @@ void anim_reset()
         anim_set[index].field_0 = -1000;
         anim_set[index].flags = 0;
     }
+
+    path_cache_clear();
 }
 
 // 0x413548
@@ -1519,6 +1594,7 @@ static int anim_set_check(int animationSequenceIndex)
                 }
             } else {
                 animationDescription->owner->flags |= animationDescription->objectFlag;
+                obj_blocking_changed(animationDescription->owner);
             }
 
             rc = anim_set_continue(animationSequenceIndex, 0);
@@ -1534,6 +1610,7 @@ static int anim_set_check(int animationSequenceIndex)
                 }
             } else {
                 animationDescription->owner->flags &= ~animationDescription->objectFlag;
+                obj_blocking_changed(animationDescription->owner);
             }
 
             rc = anim_set_continue(animationSequenceIndex, 0);
@@ -1766,7 +1843,64 @@ static bool anim_can_use_door(Object* critter, Object* door)
 // 0x4159D4
 int make_path(Object* object, int from, int to, unsigned char* rotations, int a5)
 {
-    return make_path_func(object, from, to, rotations, a5, obj_blocking_at);
+    int elevation = object->elevation;
+    unsigned int epoch = obj_blocking_epoch(elevation);
+
+    int flags = 0;
+    if (a5) {
+        flags |= PATH_CACHE_CHECK_DESTINATION;
+    }
+
+    // Rotation penalty is only applied outside of combat.
+    if (!isInCombat()) {
+        flags |= PATH_CACHE_NOT_IN_COMBAT;
+    }
+
+    PathCacheEntry* entry;
+    for (int index = 0; index < PATH_CACHE_CAPACITY; index++) {
+        entry = &(path_cache[index]);
+        if (entry->length != -1
+            && entry->object == object
+            && entry->objectId == object->id
+            && entry->objectPid == object->pid
+            && entry->from == from
+            && entry->to == to
+            && entry->elevation == elevation
+            && entry->epoch == epoch
+            && entry->flags == flags) {
+            path_cache_hits++;
+
+            if (rotations != NULL) {
+                memcpy(rotations, entry->rotations, entry->length);
+            }
+
+            return entry->length;
+        }
+    }
+
+    path_cache_misses++;
+
+    entry = &(path_cache[path_cache_next]);
+    path_cache_next = (path_cache_next + 1) % PATH_CACHE_CAPACITY;
+
+    entry->object = object;
+    entry->objectId = object->id;
+    entry->objectPid = object->pid;
+    entry->from = from;
+    entry->to = to;
+    entry->elevation = elevation;
+    entry->epoch = epoch;
+    entry->flags = flags;
+
+    unsigned int start = get_time();
+    entry->length = make_path_func(object, from, to, entry->rotations, a5, obj_blocking_at);
+    path_search_time += elapsed_tocks(get_time(), start);
+
+    if (rotations != NULL) {
+        memcpy(rotations, entry->rotations, entry->length);
+    }
+
+    return entry->length;
 }
 
 // 0x4159E8
@@ -1780,63 +1914,45 @@ int make_path_func(Object* object, int from, int to, unsigned char* rotations, i
 
     bool isNotInCombat = !isInCombat();
 
-    memset(seen, 0, sizeof(seen));
+    path_seen_begin();
 
-    seen[from / 8] |= 1 << (from & 7);
+    path_seen_mark(from);
 
-    child[0].tile = from;
-    child[0].from = -1;
-    child[0].rotation = 0;
-    child[0].field_C = EST(from, to);
-    child[0].field_10 = 0;
+    child_used = 0;
+    free_child_length = 0;
+    open_length = 0;
 
-    for (int index = 1; index < 2000; index += 1) {
-        child[index].tile = -1;
-    }
+    int slot = path_child_alloc();
+    child[slot].tile = from;
+    child[slot].from = -1;
+    child[slot].rotation = 0;
+    child[slot].field_C = EST(from, to);
+    child[slot].field_10 = 0;
+    path_open_push(slot);
 
     int toScreenX;
     int toScreenY;
     tile_coord(to, &toScreenX, &toScreenY, object->elevation);
 
     int closedPathNodeListLength = 0;
-    int openPathNodeListLength = 1;
+    bool found = false;
     PathNode temp;
 
-    while (1) {
-        int v63 = -1;
-
-        PathNode* prev = NULL;
-        int v12 = 0;
-        for (int index = 0; v12 < openPathNodeListLength; index += 1) {
-            PathNode* curr = &(child[index]);
-            if (curr->tile != -1) {
-                v12++;
-                if (v63 == -1 || (curr->field_C + curr->field_10) < (prev->field_C + prev->field_10)) {
-                    prev = curr;
-                    v63 = index;
-                }
-            }
-        }
-
-        PathNode* curr = &(child[v63]);
-
-        memcpy(&temp, curr, sizeof(temp));
-
-        openPathNodeListLength -= 1;
-
-        curr->tile = -1;
+    while (open_length != 0) {
+        slot = path_open_pop();
+        memcpy(&temp, &(child[slot]), sizeof(temp));
+        path_child_free(slot);
 
         if (temp.tile == to) {
-            if (openPathNodeListLength == 0) {
-                openPathNodeListLength = 1;
-            }
+            found = true;
             break;
         }
 
-        PathNode* curr1 = &(dad[closedPathNodeListLength]);
-        memcpy(curr1, &temp, sizeof(temp));
+        dad_index[temp.tile] = (short)closedPathNodeListLength;
+        memcpy(&(dad[closedPathNodeListLength]), &temp, sizeof(temp));
 
         closedPathNodeListLength += 1;
+        path_nodes_expanded++;
 
         if (closedPathNodeListLength == 2000) {
             return 0;
@@ -1844,8 +1960,7 @@ int make_path_func(Object* object, int from, int to, unsigned char* rotations, i
 
         for (int rotation = 0; rotation < ROTATION_COUNT; rotation++) {
             int tile = tile_num_in_direction(temp.tile, rotation, 1);
-            int bit = 1 << (tile & 7);
-            if ((seen[tile / 8] & bit) != 0) {
+            if (path_seen_test(tile)) {
                 continue;
             }
 
@@ -1858,22 +1973,17 @@ int make_path_func(Object* object, int from, int to, unsigned char* rotations, i
                 }
             }
 
-            int v25 = 0;
-            for (; v25 < 2000; v25++) {
-                if (child[v25].tile == -1) {
-                    break;
-                }
-            }
-
-            openPathNodeListLength += 1;
-
-            if (openPathNodeListLength == 2000) {
+            // NOTE: Open list is limited to 1999 nodes, the original
+            // implementation bails out when it's about to reach 2000.
+            if (open_length + 1 == 2000) {
                 return 0;
             }
 
-            seen[tile / 8] |= bit;
+            path_seen_mark(tile);
 
-            PathNode* v27 = &(child[v25]);
+            slot = path_child_alloc();
+
+            PathNode* v27 = &(child[slot]);
             v27->tile = tile;
             v27->from = temp.tile;
             v27->rotation = rotation;
@@ -1888,55 +1998,229 @@ int make_path_func(Object* object, int from, int to, unsigned char* rotations, i
             if (isNotInCombat && temp.rotation != rotation) {
                 v27->field_10 += 10;
             }
+
+            path_open_push(slot);
         }
+    }
 
-        if (openPathNodeListLength == 0) {
+    if (!found) {
+        return 0;
+    }
+
+    unsigned char* v39 = rotations;
+    int index = 0;
+    for (; index < 800; index++) {
+        if (temp.tile == from) {
             break;
         }
+
+        if (v39 != NULL) {
+            *v39 = temp.rotation & 0xFF;
+            v39 += 1;
+        }
+
+        memcpy(&temp, &(dad[dad_index[temp.from]]), sizeof(temp));
     }
 
-    if (openPathNodeListLength != 0) {
-        unsigned char* v39 = rotations;
-        int index = 0;
-        for (; index < 800; index++) {
-            if (temp.tile == from) {
-                break;
-            }
+    if (rotations != NULL) {
+        // Looks like array resevering, probably because A* finishes it's path from end to start,
+        // this probably reverses it start-to-end.
+        unsigned char* beginning = rotations;
+        unsigned char* ending = rotations + index - 1;
+        int middle = index / 2;
+        for (int index = 0; index < middle; index++) {
+            unsigned char rotation = *ending;
+            *ending = *beginning;
+            *beginning = rotation;
 
-            if (v39 != NULL) {
-                *v39 = temp.rotation & 0xFF;
-                v39 += 1;
-            }
+            ending -= 1;
+            beginning += 1;
+        }
+    }
 
-            int j = 0;
-            while (dad[j].tile != temp.from) {
-                j++;
-            }
+    return index;
+}
 
-            PathNode* v36 = &(dad[j]);
-            memcpy(&temp, v36, sizeof(temp));
+// Starts new generation of visited tiles. The table is only cleared when
+// generation counter wraps around.
+static void path_seen_begin()
+{
+    seen_generation += 1;
+    if (seen_generation == 0) {
+        memset(seen, 0, sizeof(seen));
+        seen_generation = 1;
+    }
+}
+
+static bool path_seen_test(int tile)
+{
+    return seen[tile] == seen_generation;
+}
+
+static void path_seen_mark(int tile)
+{
+    seen[tile] = seen_generation;
+}
+
+// Returns lowest unused slot in [child] array.
+//
+// NOTE: The original implementation picked open nodes with a linear scan over
+// [child] taking the first cheapest one, so ties are resolved by slot index.
+// Slots are handed out in the same order to keep resulting paths identical.
+static int path_child_alloc()
+{
+    if (free_child_length == 0) {
+        return child_used++;
+    }
+
+    int slot = free_child[0];
+
+    free_child_length -= 1;
+    free_child[0] = free_child[free_child_length];
+
+    int index = 0;
+    while (1) {
+        int left = index * 2 + 1;
+        if (left >= free_child_length) {
+            break;
         }
 
-        if (rotations != NULL) {
-            // Looks like array resevering, probably because A* finishes it's path from end to start,
-            // this probably reverses it start-to-end.
-            unsigned char* beginning = rotations;
-            unsigned char* ending = rotations + index - 1;
-            int middle = index / 2;
-            for (int index = 0; index < middle; index++) {
-                unsigned char rotation = *ending;
-                *ending = *beginning;
-                *beginning = rotation;
+        int smallest = left;
+        int right = left + 1;
+        if (right < free_child_length && free_child[right] < free_child[left]) {
+            smallest = right;
+        }
 
-                ending -= 1;
-                beginning += 1;
-            }
+        if (free_child[index] <= free_child[smallest]) {
+            break;
         }
 
-        return index;
+        int tmp = free_child[index];
+        free_child[index] = free_child[smallest];
+        free_child[smallest] = tmp;
+
+        index = smallest;
     }
 
-    return 0;
+    return slot;
+}
+
+static void path_child_free(int slot)
+{
+    int index = free_child_length;
+    free_child_length += 1;
+
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (free_child[parent] <= slot) {
+            break;
+        }
+
+        free_child[index] = free_child[parent];
+        index = parent;
+    }
+
+    free_child[index] = slot;
+}
+
+// Returns `true` if open node in [slot1] should be expanded before node in
+// [slot2].
+static bool path_open_less(int slot1, int slot2)
+{
+    int cost1 = child[slot1].field_C + child[slot1].field_10;
+    int cost2 = child[slot2].field_C + child[slot2].field_10;
+    if (cost1 != cost2) {
+        return cost1 < cost2;
+    }
+
+    return slot1 < slot2;
+}
+
+static void path_open_push(int slot)
+{
+    int index = open_length;
+    open_length += 1;
+
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!path_open_less(slot, open_heap[parent])) {
+            break;
+        }
+
+        open_heap[index] = open_heap[parent];
+        index = parent;
+    }
+
+    open_heap[index] = slot;
+}
+
+static int path_open_pop()
+{
+    int slot = open_heap[0];
+
+    open_length -= 1;
+
+    int last = open_heap[open_length];
+    int index = 0;
+    while (1) {
+        int left = index * 2 + 1;
+        if (left >= open_length) {
+            break;
+        }
+
+        int smallest = left;
+        int right = left + 1;
+        if (right < open_length && path_open_less(open_heap[right], open_heap[left])) {
+            smallest = right;
+        }
+
+        if (!path_open_less(open_heap[smallest], last)) {
+            break;
+        }
+
+        open_heap[index] = open_heap[smallest];
+        index = smallest;
+    }
+
+    if (open_length != 0) {
+        open_heap[index] = last;
+    }
+
+    return slot;
+}
+
+static void path_cache_clear()
+{
+    for (int index = 0; index < PATH_CACHE_CAPACITY; index++) {
+        path_cache[index].length = -1;
+    }
+
+    path_cache_next = 0;
+}
+
+// Prints [path_cache] hits and misses, and work done by [make_path_func] to
+// serve the misses, into [dest].
+bool path_cache_stats(char* dest)
+{
+    if (dest == NULL) {
+        return false;
+    }
+
+    sprintf(dest, "Path cache: %d hits, %d misses, %d nodes expanded, %u ms searching.\n", path_cache_hits, path_cache_misses, path_nodes_expanded, path_search_time);
+
+    return true;
+}
+
+// Returns `true` if [callback] is known to report nothing at [tile] which
+// would stop straight path (projectiles ignore `OBJECT_SHOOT_THRU` objects
+// when [a6] is 32), so it can be skipped altogether.
+static bool straight_path_tile_clear(PathBuilderCallback* callback, int a6, int tile, int elevation)
+{
+    if (callback != obj_blocking_at) {
+        return false;
+    }
+
+    return !obj_blocking_possible(a6 == 32 ? OBJECT_BLOCKING_SHOOT : OBJECT_BLOCKING_MOVE, tile, elevation);
 }
 
 // 0x415D9C
@@ -2074,7 +2358,7 @@ int make_straight_path_func(Object* a1, int from, int to, StraightPathNode* path
             middle += v48;
 
             if (tile != prevTile) {
-                if (a5 != NULL) {
+                if (a5 != NULL && !straight_path_tile_clear(callback, a6, tile, a1->elevation)) {
                     Object* obj = callback(a1, tile, a1->elevation);
                     if (obj != NULL) {
                         if (obj != *a5 && (a6 != 32 || (obj->flags & OBJECT_SHOOT_THRU) == 0)) {
@@ -2127,7 +2411,7 @@ int make_straight_path_func(Object* a1, int from, int to, StraightPathNode* path
             middle += v47;
 
             if (tile != prevTile) {
-                if (a5 != NULL) {
+                if (a5 != NULL && !straight_path_tile_clear(callback, a6, tile, a1->elevation)) {
                     Object* obj = callback(a1, tile, a1->elevation);
                     if (obj != NULL) {
                         if (obj != *a5 && (a6 != 32 || (obj->flags & OBJECT_SHOOT_THRU) == 0)) {
@@ -2171,11 +2455,13 @@ static int anim_move_to_object(Object* from, Object* to, int a3, int anim, int a
 {
     bool hidden = (to->flags & OBJECT_HIDDEN);
     to->flags |= OBJECT_HIDDEN;
+    obj_blocking_changed(to);
 
     int moveSadIndex = anim_move(from, to->tile, to->elevation, -1, anim, 0, animationSequenceIndex);
 
     if (!hidden) {
         to->flags &= ~OBJECT_HIDDEN;
+        obj_blocking_changed(to);
     }
 
     if (moveSadIndex == -1) {
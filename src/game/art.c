@@ -17,6 +17,8 @@
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 
+#define ART_EXISTS_INITIAL_CAPACITY 256
+
 typedef struct ArtListDescription {
     int flags;
     char dir[16];
@@ -24,6 +26,20 @@ typedef struct ArtListDescription {
     int fileNamesLength; // number of entries in list
 } ArtListDescription;
 
+// An entry of [art_exists_table].
+typedef struct ArtExistsEntry {
+    int fid;
+    int db;
+    bool used;
+    bool exists;
+} ArtExistsEntry;
+
+static bool art_exists_lookup(int fid);
+static ArtExistsEntry* art_exists_find(int fid, int db);
+static int art_exists_grow();
+static void art_exists_free();
+static void art_pending_free();
+
 // 0x4FEAB4
 static ArtListDescription art[OBJ_TYPE_COUNT] = {
     { 0, "items", NULL, 0 },
@@ -70,6 +86,36 @@ HeadDescription* head_info;
 // 0x56B85C
 static int* anon_alias;
 
+// Art loaded by [art_data_size] to calculate size of its index, handed over
+// to [art_data_load] which is expected to be called next for the same fid.
+// When the cache gives up in between, it is freed by the next request for
+// any other fid or by [art_flush], so at most one art file is held here.
+static Art* art_pending = NULL;
+
+// Fid of [art_pending].
+static int art_pending_fid = -1;
+
+// Size of [art_pending] as loaded from file.
+static int art_pending_size = 0;
+
+// Size of [art_pending] including its index.
+static int art_pending_total_size = 0;
+
+// Open-addressing table (linear probing) memoizing results of [art_exists]
+// keyed by fid and database it was looked up in. It is discarded whenever
+// [db_generation] changes, so patch files added or databases reopened are
+// picked up.
+static ArtExistsEntry* art_exists_table = NULL;
+
+// Number of entries in [art_exists_table], always a power of two.
+static int art_exists_capacity = 0;
+
+// Number of used entries in [art_exists_table].
+static int art_exists_length = 0;
+
+// Value of [db_generation] [art_exists_table] was filled at.
+static unsigned int art_exists_generation = 0;
+
 // 0x418170
 int art_init()
 {
@@ -257,6 +303,10 @@ void art_exit()
 {
     cache_exit(&art_cache);
 
+    art_pending_free();
+
+    art_exists_free();
+
     mem_free(anon_alias);
 
     for (int index = 0; index < OBJ_TYPE_COUNT; index++) {
@@ -445,6 +495,8 @@ int art_ptr_unlock(CacheEntry* handle)
 // 0x418A48
 int art_flush()
 {
+    art_pending_free();
+
     return cache_flush(&art_cache);
 }
 
@@ -780,6 +832,40 @@ int art_frame_hot(Art* art, int frame, int direction, int* xPtr, int* yPtr)
     return 0;
 }
 
+// Retrieves size, pixels and hotspot of a frame at once. Any of the pointers
+// can be NULL.
+int art_frame_info(Art* art, int frame, int direction, int* widthPtr, int* heightPtr, unsigned char** dataPtr, int* xPtr, int* yPtr)
+{
+    ArtFrame* frm;
+
+    frm = frame_ptr(art, frame, direction);
+    if (frm == NULL) {
+        return -1;
+    }
+
+    if (widthPtr != NULL) {
+        *widthPtr = frm->width;
+    }
+
+    if (heightPtr != NULL) {
+        *heightPtr = frm->height;
+    }
+
+    if (dataPtr != NULL) {
+        *dataPtr = (unsigned char*)frm + sizeof(*frm);
+    }
+
+    if (xPtr != NULL) {
+        *xPtr = frm->x;
+    }
+
+    if (yPtr != NULL) {
+        *yPtr = frm->y;
+    }
+
+    return 0;
+}
+
 // 0x418FD4
 int art_frame_offset(Art* art, int rotation, int* xPtr, int* yPtr)
 {
@@ -806,6 +892,26 @@ unsigned char* art_frame_data(Art* art, int frame, int direction)
     return (unsigned char*)frm + sizeof(*frm);
 }
 
+// Returns row index of opaque spans of the frame (see [art_build_index]), or
+// NULL if [art] has no index.
+int* art_frame_spans(Art* art, int frame, int direction)
+{
+    if (art == NULL || (art->field_0 & ART_FLAG_INDEX) == 0) {
+        return NULL;
+    }
+
+    if (direction < 0 || direction >= ROTATION_COUNT) {
+        return NULL;
+    }
+
+    if (frame < 0 || frame >= art->frameCount) {
+        return NULL;
+    }
+
+    int* offsets = (int*)((unsigned char*)art + ART_INDEX_OFFSET(art)) + ROTATION_COUNT * art->frameCount;
+    return (int*)((unsigned char*)art + offsets[direction * art->frameCount + frame]);
+}
+
 // 0x419008
 ArtFrame* frame_ptr(Art* art, int frame, int rotation)
 {
@@ -821,6 +927,11 @@ ArtFrame* frame_ptr(Art* art, int frame, int rotation)
         return NULL;
     }
 
+    if ((art->field_0 & ART_FLAG_INDEX) != 0) {
+        int* frames = (int*)((unsigned char*)art + ART_INDEX_OFFSET(art));
+        return (ArtFrame*)((unsigned char*)art + frames[rotation * art->frameCount + frame]);
+    }
+
     ArtFrame* frm = (ArtFrame*)((unsigned char*)art + sizeof(*art) + art->dataOffsets[rotation]);
     for (int index = 0; index < frame; index++) {
         frm = (ArtFrame*)((unsigned char*)frm + sizeof(*frm) + frm->size);
@@ -831,7 +942,20 @@ ArtFrame* frame_ptr(Art* art, int frame, int rotation)
 // 0x419050
 bool art_exists(int fid)
 {
-    bool result = false;
+    return art_exists_lookup(fid);
+}
+
+// NOTE: Exactly the same implementation as `art_exists`.
+//
+// 0x4190B8
+bool art_fid_valid(int fid)
+{
+    return art_exists_lookup(fid);
+}
+
+// Looks up [fid] in [art_exists_table], probing database on miss.
+static bool art_exists_lookup(int fid)
+{
     int oldDb = -1;
 
     if (FID_TYPE(fid) == OBJ_TYPE_CRITTER) {
@@ -839,6 +963,26 @@ bool art_exists(int fid)
         db_select(critter_db_handle);
     }
 
+    int db = db_current();
+
+    if (art_exists_generation != db_generation()) {
+        for (int index = 0; index < art_exists_capacity; index++) {
+            art_exists_table[index].used = false;
+        }
+        art_exists_length = 0;
+        art_exists_generation = db_generation();
+    }
+
+    ArtExistsEntry* entry = art_exists_find(fid, db);
+    if (entry != NULL && entry->used) {
+        if (oldDb != -1) {
+            db_select(oldDb);
+        }
+        return entry->exists;
+    }
+
+    bool result = false;
+
     char* filePath = art_get_name(fid);
     if (filePath != NULL) {
         dir_entry de;
@@ -851,35 +995,90 @@ bool art_exists(int fid)
         db_select(oldDb);
     }
 
+    // Keep load factor under 3/4. Failing to grow only means result is not
+    // memoized.
+    if (entry == NULL || (art_exists_length + 1) * 4 > art_exists_capacity * 3) {
+        entry = art_exists_grow() == 0 ? art_exists_find(fid, db) : NULL;
+    }
+
+    if (entry != NULL) {
+        entry->fid = fid;
+        entry->db = db;
+        entry->used = true;
+        entry->exists = result;
+        art_exists_length++;
+    }
+
     return result;
 }
 
-// NOTE: Exactly the same implementation as `art_exists`.
-//
-// 0x4190B8
-bool art_fid_valid(int fid)
+// Returns [art_exists_table] entry for [fid] in [db], or unused entry where
+// it should be placed, or NULL if table is not allocated.
+static ArtExistsEntry* art_exists_find(int fid, int db)
 {
-    bool result = false;
-    int oldDb = -1;
+    if (art_exists_capacity == 0) {
+        return NULL;
+    }
 
-    if (FID_TYPE(fid) == OBJ_TYPE_CRITTER) {
-        oldDb = db_current();
-        db_select(critter_db_handle);
+    unsigned int mask = art_exists_capacity - 1;
+    unsigned int hash = (unsigned int)fid ^ (unsigned int)db;
+    hash ^= hash >> 16;
+    hash *= 0x45D9F3B;
+    hash ^= hash >> 16;
+
+    unsigned int pos = hash & mask;
+    while (art_exists_table[pos].used) {
+        if (art_exists_table[pos].fid == fid && art_exists_table[pos].db == db) {
+            break;
+        }
+        pos = (pos + 1) & mask;
     }
 
-    char* filePath = art_get_name(fid);
-    if (filePath != NULL) {
-        dir_entry de;
-        if (db_dir_entry(filePath, &de) != -1) {
-            result = true;
+    return &(art_exists_table[pos]);
+}
+
+// Doubles [art_exists_table] capacity and rehashes existing entries.
+static int art_exists_grow()
+{
+    int capacity = art_exists_capacity != 0 ? art_exists_capacity * 2 : ART_EXISTS_INITIAL_CAPACITY;
+    ArtExistsEntry* entries = (ArtExistsEntry*)mem_malloc(sizeof(*entries) * capacity);
+    if (entries == NULL) {
+        return -1;
+    }
+
+    for (int index = 0; index < capacity; index++) {
+        entries[index].used = false;
+    }
+
+    ArtExistsEntry* oldEntries = art_exists_table;
+    int oldCapacity = art_exists_capacity;
+
+    art_exists_table = entries;
+    art_exists_capacity = capacity;
+
+    for (int index = 0; index < oldCapacity; index++) {
+        if (oldEntries[index].used) {
+            *art_exists_find(oldEntries[index].fid, oldEntries[index].db) = oldEntries[index];
         }
     }
 
-    if (oldDb != -1) {
-        db_select(oldDb);
+    if (oldEntries != NULL) {
+        mem_free(oldEntries);
     }
 
-    return result;
+    return 0;
+}
+
+// Frees [art_exists_table].
+static void art_exists_free()
+{
+    if (art_exists_table != NULL) {
+        mem_free(art_exists_table);
+        art_exists_table = NULL;
+    }
+
+    art_exists_capacity = 0;
+    art_exists_length = 0;
 }
 
 // 0x419120
@@ -929,6 +1128,24 @@ int art_data_size(int fid, int* sizePtr)
         if (db_dir_entry(artFilePath, &de) == 0) {
             *sizePtr = de.length;
             result = 0;
+
+            art_pending_free();
+
+            // Load art now to see how much room its index needs, so that the
+            // cache accounts for it.
+            Art* pending;
+            if (load_frame(artFilePath, &pending) == 0) {
+                int totalSize = art_index_size(pending, de.length);
+                if (totalSize != -1) {
+                    art_pending = pending;
+                    art_pending_fid = fid;
+                    art_pending_size = de.length;
+                    art_pending_total_size = totalSize > de.length ? totalSize : de.length;
+                    *sizePtr = art_pending_total_size;
+                } else {
+                    mem_free(pending);
+                }
+            }
         }
     }
 
@@ -950,6 +1167,22 @@ int art_data_load(int fid, int* sizePtr, unsigned char* data)
         db_select(critter_db_handle);
     }
 
+    if (art_pending != NULL && art_pending_fid == fid) {
+        memcpy(data, art_pending, art_pending_size);
+        art_build_index((Art*)data);
+        *sizePtr = art_pending_total_size;
+
+        art_pending_free();
+
+        if (oldDb != -1) {
+            db_select(oldDb);
+        }
+
+        return 0;
+    }
+
+    art_pending_free();
+
     char* artFileName = art_get_name(fid);
     if (artFileName != NULL) {
         if (load_frame_into(artFileName, data) == 0) {
@@ -972,6 +1205,16 @@ void art_data_free(void* ptr)
     mem_free(ptr);
 }
 
+// Frees [art_pending] if there is one.
+static void art_pending_free()
+{
+    if (art_pending != NULL) {
+        mem_free(art_pending);
+        art_pending = NULL;
+        art_pending_fid = -1;
+    }
+}
+
 // 0x4192C8
 int art_id(int objectType, int frmId, int animType, int a3, int rotation)
 {
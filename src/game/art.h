@@ -78,6 +78,13 @@ typedef struct Art {
 
 static_assert(sizeof(Art) == 62, "wrong size");
 
+// Set in `Art.field_0` when frame index was built (see [art_build_index]).
+#define ART_FLAG_INDEX 0x80000000
+
+// Offset from the beginning of [Art] to the frame index which follows raw
+// frame data.
+#define ART_INDEX_OFFSET(art) (((int)sizeof(Art) + (art)->field_3A + 3) & ~3)
+
 typedef struct ArtFrame {
     short width;
     short height;
@@ -86,6 +93,12 @@ typedef struct ArtFrame {
     short y;
 } ArtFrame;
 
+// Run of opaque (non-zero) pixels in a frame row.
+typedef struct ArtSpan {
+    unsigned short x;
+    unsigned short length;
+} ArtSpan;
+
 typedef struct HeadDescription {
     int goodFidgetCount;
     int neutralFidgetCount;
@@ -141,9 +154,11 @@ int art_frame_width(Art* art, int frame, int direction);
 int art_frame_length(Art* art, int frame, int direction);
 int art_frame_width_length(Art* art, int frame, int direction, int* out_width, int* out_height);
 int art_frame_hot(Art* art, int frame, int direction, int* a4, int* a5);
+int art_frame_info(Art* art, int frame, int direction, int* widthPtr, int* heightPtr, unsigned char** dataPtr, int* xPtr, int* yPtr);
 int art_frame_offset(Art* art, int rotation, int* out_offset_x, int* out_offset_y);
 unsigned char* art_frame_data(Art* art, int frame, int direction);
 ArtFrame* frame_ptr(Art* art, int frame, int direction);
+int* art_frame_spans(Art* art, int frame, int direction);
 bool art_exists(int fid);
 bool art_fid_valid(int fid);
 int art_alias_num(int a1);
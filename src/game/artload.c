@@ -1,9 +1,17 @@
 #include "game/artload.h"
 
+#include <string.h>
+
 #include "plib/gnw/memory.h"
 
 static int art_readSubFrameData(unsigned char* data, DB_FILE* stream, int count);
 static int art_readFrameData(Art* art, DB_FILE* stream);
+static int art_frame_spans_size(unsigned char* data, int width, int height);
+static int load_frame_mapped(const unsigned char* data, int size, Art** artPtr);
+static int art_parseSubFrameData(unsigned char* data, const unsigned char* src, int size, int* offsetPtr, int count);
+static int art_parseFrameData(Art* art, const unsigned char* src, int size);
+static short art_decode_short(const unsigned char* data);
+static int art_decode_int(const unsigned char* data);
 
 // 0x4193A0
 static int art_readSubFrameData(unsigned char* data, DB_FILE* stream, int count)
@@ -46,6 +54,14 @@ int load_frame(const char* path, Art** artPtr)
     dir_entry de;
     DB_FILE* stream;
     int index;
+    const unsigned char* data;
+    int size;
+
+    // Stored entries of mapped datafile are parsed in place, without going
+    // through [DB_FILE] reads.
+    if (db_map_entry(path, &data, &size) == 0) {
+        return load_frame_mapped(data, size, artPtr);
+    }
 
     if (db_dir_entry(path, &de) == -1) {
         return -2;
@@ -58,6 +74,8 @@ int load_frame(const char* path, Art** artPtr)
 
     stream = db_fopen(path, "rb");
     if (stream == NULL) {
+        // NOTE: Original code leaks allocated art here.
+        mem_free(*artPtr);
         return -2;
     }
 
@@ -136,7 +154,7 @@ int art_writeSubFrameData(unsigned char* data, DB_FILE* stream, int count)
 // 0x419778
 int art_writeFrameData(Art* art, DB_FILE* stream)
 {
-    if (db_fwriteInt(stream, art->field_0) == -1) return -1;
+    if (db_fwriteInt(stream, art->field_0 & ~ART_FLAG_INDEX) == -1) return -1;
     if (db_fwriteShort(stream, art->framesPerSecond) == -1) return -1;
     if (db_fwriteShort(stream, art->actionFrame) == -1) return -1;
     if (db_fwriteShort(stream, art->frameCount) == -1) return -1;
@@ -178,3 +196,225 @@ int save_frame(const char* path, unsigned char* data)
     db_fclose(stream);
     return 0;
 }
+
+// Same as [load_frame], but parses art from [size] bytes at [data] obtained
+// with [db_map_entry].
+static int load_frame_mapped(const unsigned char* data, int size, Art** artPtr)
+{
+    int offset;
+    int index;
+
+    *artPtr = (Art*)mem_malloc(size);
+    if (*artPtr == NULL) {
+        return -1;
+    }
+
+    if (art_parseFrameData(*artPtr, data, size) != 0) {
+        mem_free(*artPtr);
+        return -3;
+    }
+
+    offset = sizeof(Art);
+    for (index = 0; index < ROTATION_COUNT; index++) {
+        if (index == 0 || (*artPtr)->dataOffsets[index - 1] != (*artPtr)->dataOffsets[index]) {
+            if (art_parseSubFrameData((unsigned char*)(*artPtr) + sizeof(Art) + (*artPtr)->dataOffsets[index], data, size, &offset, (*artPtr)->frameCount) != 0) {
+                break;
+            }
+        }
+    }
+
+    if (index < ROTATION_COUNT) {
+        mem_free(*artPtr);
+        return -5;
+    }
+
+    return 0;
+}
+
+// Memory counterpart of [art_readSubFrameData], reads frames starting at
+// [offsetPtr] in [src] and advances it.
+static int art_parseSubFrameData(unsigned char* data, const unsigned char* src, int size, int* offsetPtr, int count)
+{
+    unsigned char* ptr = data;
+    int offset = *offsetPtr;
+    for (int index = 0; index < count; index++) {
+        ArtFrame* frame = (ArtFrame*)ptr;
+
+        if (size - offset < (int)sizeof(ArtFrame)) return -1;
+
+        frame->width = art_decode_short(src + offset);
+        frame->height = art_decode_short(src + offset + 2);
+        frame->size = art_decode_int(src + offset + 4);
+        frame->x = art_decode_short(src + offset + 8);
+        frame->y = art_decode_short(src + offset + 10);
+        offset += sizeof(ArtFrame);
+
+        if (frame->size < 0 || size - offset < frame->size) return -1;
+
+        memcpy(ptr + sizeof(ArtFrame), src + offset, frame->size);
+        offset += frame->size;
+
+        ptr += sizeof(ArtFrame) + frame->size;
+    }
+
+    *offsetPtr = offset;
+
+    return 0;
+}
+
+// Memory counterpart of [art_readFrameData].
+static int art_parseFrameData(Art* art, const unsigned char* src, int size)
+{
+    if (size < (int)sizeof(Art)) return -1;
+
+    art->field_0 = art_decode_int(src);
+    art->framesPerSecond = art_decode_short(src + 4);
+    art->actionFrame = art_decode_short(src + 6);
+    art->frameCount = art_decode_short(src + 8);
+    for (int index = 0; index < ROTATION_COUNT; index++) {
+        art->xOffsets[index] = art_decode_short(src + 10 + index * 2);
+        art->yOffsets[index] = art_decode_short(src + 22 + index * 2);
+        art->dataOffsets[index] = art_decode_int(src + 34 + index * 4);
+    }
+    art->field_3A = art_decode_int(src + 58);
+
+    return 0;
+}
+
+// Art files are big-endian.
+static short art_decode_short(const unsigned char* data)
+{
+    return (short)((data[0] << 8) | data[1]);
+}
+
+static int art_decode_int(const unsigned char* data)
+{
+    return (int)(((unsigned int)data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3]);
+}
+
+// Returns number of bytes needed for spans of [width]x[height] frame [data].
+static int art_frame_spans_size(unsigned char* data, int width, int height)
+{
+    int count = 0;
+    for (int y = 0; y < height; y++) {
+        bool opaque = false;
+        for (int x = 0; x < width; x++) {
+            if (*data++ != 0) {
+                if (!opaque) {
+                    count++;
+                    opaque = true;
+                }
+            } else {
+                opaque = false;
+            }
+        }
+    }
+
+    return sizeof(int) * (height + 1) + sizeof(ArtSpan) * count;
+}
+
+// Returns size of buffer needed to hold [art] (which currently occupies [size]
+// bytes) together with its index, or -1 if index cannot be built for it.
+int art_index_size(Art* art, int size)
+{
+    if ((art->field_0 & ART_FLAG_INDEX) != 0 || art->frameCount <= 0) {
+        return -1;
+    }
+
+    // Index is placed right after frame data, which must be where header
+    // says it ends.
+    int end = sizeof(Art) + art->field_3A;
+    if (art->field_3A < 0 || end > size) {
+        return -1;
+    }
+
+    int total = ART_INDEX_OFFSET(art) + 2 * sizeof(int) * ROTATION_COUNT * art->frameCount;
+
+    for (int rotation = 0; rotation < ROTATION_COUNT; rotation++) {
+        if (rotation != 0 && art->dataOffsets[rotation - 1] == art->dataOffsets[rotation]) {
+            continue;
+        }
+
+        int offset = sizeof(Art) + art->dataOffsets[rotation];
+        for (int frame = 0; frame < art->frameCount; frame++) {
+            if (offset < (int)sizeof(Art) || offset + (int)sizeof(ArtFrame) > end) {
+                return -1;
+            }
+
+            ArtFrame* frm = (ArtFrame*)((unsigned char*)art + offset);
+            if (frm->width < 0 || frm->height < 0 || frm->size < frm->width * frm->height || offset + (int)sizeof(ArtFrame) + frm->size > end) {
+                return -1;
+            }
+
+            total += (art_frame_spans_size((unsigned char*)frm + sizeof(ArtFrame), frm->width, frm->height) + 3) & ~3;
+            offset += sizeof(ArtFrame) + frm->size;
+        }
+    }
+
+    return total;
+}
+
+// Builds frame index of [art] and marks it with `ART_FLAG_INDEX`. Buffer
+// holding [art] must be at least as large as reported by [art_index_size].
+//
+// Index consists of offsets (from [art]) of each frame for every rotation,
+// then offsets of each frame's opaque spans for every rotation, followed by
+// spans of every frame. Frame spans start with `height + 1` indexes of the
+// first span of each row (the last one being the total number of spans),
+// followed by spans themselves.
+void art_build_index(Art* art)
+{
+    unsigned char* base = (unsigned char*)art;
+    int* frames = (int*)(base + ART_INDEX_OFFSET(art));
+    int* offsets = frames + ROTATION_COUNT * art->frameCount;
+    int offset = ART_INDEX_OFFSET(art) + 2 * sizeof(int) * ROTATION_COUNT * art->frameCount;
+
+    for (int rotation = 0; rotation < ROTATION_COUNT; rotation++) {
+        if (rotation != 0 && art->dataOffsets[rotation - 1] == art->dataOffsets[rotation]) {
+            memcpy(frames + rotation * art->frameCount, frames + (rotation - 1) * art->frameCount, sizeof(int) * art->frameCount);
+            memcpy(offsets + rotation * art->frameCount, offsets + (rotation - 1) * art->frameCount, sizeof(int) * art->frameCount);
+            continue;
+        }
+
+        ArtFrame* frm = (ArtFrame*)(base + sizeof(Art) + art->dataOffsets[rotation]);
+        for (int frame = 0; frame < art->frameCount; frame++) {
+            unsigned char* data = (unsigned char*)frm + sizeof(ArtFrame);
+            int* rows = (int*)(base + offset);
+            ArtSpan* spans = (ArtSpan*)(rows + frm->height + 1);
+            int count = 0;
+
+            frames[rotation * art->frameCount + frame] = (unsigned char*)frm - base;
+
+            for (int y = 0; y < frm->height; y++) {
+                rows[y] = count;
+
+                int x = 0;
+                while (x < frm->width) {
+                    if (data[x] == 0) {
+                        x++;
+                        continue;
+                    }
+
+                    int start = x;
+                    while (x < frm->width && data[x] != 0) {
+                        x++;
+                    }
+
+                    spans[count].x = start;
+                    spans[count].length = x - start;
+                    count++;
+                }
+
+                data += frm->width;
+            }
+            rows[frm->height] = count;
+
+            offsets[rotation * art->frameCount + frame] = offset;
+            offset += (sizeof(int) * (frm->height + 1) + sizeof(ArtSpan) * count + 3) & ~3;
+
+            frm = (ArtFrame*)((unsigned char*)frm + sizeof(ArtFrame) + frm->size);
+        }
+    }
+
+    art->field_0 |= ART_FLAG_INDEX;
+}
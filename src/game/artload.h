@@ -9,5 +9,7 @@ int load_frame_into(const char* path, unsigned char* data);
 int art_writeSubFrameData(unsigned char* data, DB_FILE* stream, int count);
 int art_writeFrameData(Art* art, DB_FILE* stream);
 int save_frame(const char* path, unsigned char* data);
+int art_index_size(Art* art, int size);
+void art_build_index(Art* art);
 
 #endif /* FALLOUT_GAME_ARTLOAD_H_ */
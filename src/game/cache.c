@@ -9,22 +9,30 @@
 #include "plib/gnw/debug.h"
 #include "plib/gnw/memory.h"
 
-static_assert(sizeof(CacheEntry) == 32, "wrong size");
-static_assert(sizeof(Cache) == 84, "wrong size");
-
-static bool cache_add(Cache* cache, int key, int* indexPtr);
-static bool cache_insert(Cache* cache, CacheEntry* cacheEntry, int index);
-static int cache_find(Cache* cache, int key, int* indexPtr);
+static_assert(sizeof(CacheEntry) == 44, "wrong size");
+static_assert(sizeof(Cache) == 100, "wrong size");
+
+static bool cache_add(Cache* cache, int key, CacheEntry** cacheEntryPtr);
+static bool cache_insert(Cache* cache, CacheEntry* cacheEntry);
+static void cache_remove(Cache* cache, CacheEntry* cacheEntry);
+static CacheEntry* cache_find(Cache* cache, int key);
+static unsigned int cache_hash(Cache* cache, int key);
+static bool cache_resize_buckets(Cache* cache, int newLength);
 static int cache_create_item(CacheEntry** cacheEntryPtr);
 static bool cache_init_item(CacheEntry* cacheEntry);
 static bool cache_destroy_item(Cache* cache, CacheEntry* cacheEntry);
 static bool cache_unlock_all(Cache* cache);
 static bool cache_reset_counter(Cache* cache);
 static bool cache_make_room(Cache* cache, int size);
-static bool cache_purge(Cache* cache);
+static bool cache_purge(Cache* cache, int end);
 static bool cache_resize_array(Cache* cache, int newCapacity);
 static int cache_compare_make_room(const void* a1, const void* a2);
 static int cache_compare_reset_counter(const void* a1, const void* a2);
+static void cache_eviction_push(Cache* cache, CacheEntry* cacheEntry);
+static CacheEntry* cache_eviction_pop(Cache* cache);
+static void cache_eviction_remove(Cache* cache, CacheEntry* cacheEntry);
+static void cache_eviction_sift_up(Cache* cache, int index);
+static void cache_eviction_sift_down(Cache* cache, int index);
 
 // 0x4FEC7C
 static int lock_sound_ticker = 0;
@@ -45,13 +53,21 @@ bool cache_init(Cache* cache, CacheSizeProc* sizeProc, CacheReadProc* readProc,
     cache->sizeProc = sizeProc;
     cache->readProc = readProc;
     cache->freeProc = freeProc;
+    cache->buckets = NULL;
+    cache->bucketsLength = 0;
+    cache->eviction = (CacheEntry**)mem_malloc(sizeof(*cache->eviction) * cache->entriesCapacity);
+    cache->evictionLength = 0;
 
-    if (cache->entries == NULL) {
+    if (cache->entries == NULL || cache->eviction == NULL) {
         return false;
     }
 
     memset(cache->entries, 0, sizeof(*cache->entries) * cache->entriesCapacity);
 
+    if (!cache_resize_buckets(cache, CACHE_BUCKETS_INITIAL_CAPACITY)) {
+        return false;
+    }
+
     return true;
 }
 
@@ -77,6 +93,20 @@ bool cache_exit(Cache* cache)
         cache->entries = NULL;
     }
 
+    if (cache->buckets != NULL) {
+        mem_free(cache->buckets);
+        cache->buckets = NULL;
+    }
+
+    cache->bucketsLength = 0;
+
+    if (cache->eviction != NULL) {
+        mem_free(cache->eviction);
+        cache->eviction = NULL;
+    }
+
+    cache->evictionLength = 0;
+
     cache->sizeProc = NULL;
     cache->readProc = NULL;
     cache->freeProc = NULL;
@@ -87,13 +117,11 @@ bool cache_exit(Cache* cache)
 // 0x41EAC0
 int cache_query(Cache* cache, int key)
 {
-    int index;
-
     if (cache == NULL) {
         return 0;
     }
 
-    if (cache_find(cache, key, &index) != 2) {
+    if (cache_find(cache, key) == NULL) {
         return 0;
     }
 
@@ -109,33 +137,37 @@ bool cache_lock(Cache* cache, int key, void** data, CacheEntry** cacheEntryPtr)
 
     *cacheEntryPtr = NULL;
 
-    int index;
-    int rc = cache_find(cache, key, &index);
-    if (rc == 2) {
+    CacheEntry* cacheEntry = cache_find(cache, key);
+    if (cacheEntry != NULL) {
         // Use existing cache entry.
-        CacheEntry* cacheEntry = cache->entries[index];
+        if (cacheEntry->referenceCount == 0) {
+            // Eviction priority is about to change, entry is re-added to
+            // eviction heap when it's unlocked.
+            cache_eviction_remove(cache, cacheEntry);
+        }
+
         cacheEntry->hits++;
-    } else if (rc == 3) {
+    } else {
         // New cache entry is required.
         if (cache->entriesLength >= INT_MAX) {
             return false;
         }
 
-        if (!cache_add(cache, key, &index)) {
+        if (!cache_add(cache, key, &cacheEntry)) {
             return false;
         }
 
+        cache_eviction_remove(cache, cacheEntry);
+
         lock_sound_ticker %= 4;
         if (lock_sound_ticker == 0) {
             soundUpdate();
         }
-    } else {
-        return false;
     }
 
-    CacheEntry* cacheEntry = cache->entries[index];
     if (cacheEntry->referenceCount == 0) {
         if (!heap_lock(&(cache->heap), cacheEntry->heapHandleIndex, &(cacheEntry->data))) {
+            cache_eviction_push(cache, cacheEntry);
             return false;
         }
     }
@@ -170,6 +202,7 @@ bool cache_unlock(Cache* cache, CacheEntry* cacheEntry)
 
     if (cacheEntry->referenceCount == 0) {
         heap_unlock(&(cache->heap), cacheEntry->heapHandleIndex);
+        cache_eviction_push(cache, cacheEntry);
     }
 
     return true;
@@ -178,25 +211,25 @@ bool cache_unlock(Cache* cache, CacheEntry* cacheEntry)
 // 0x41EDEC
 int cache_discard(Cache* cache, int key)
 {
-    int index;
     CacheEntry* cacheEntry;
 
     if (cache == NULL) {
         return 0;
     }
 
-    if (cache_find(cache, key, &index) != 2) {
+    cacheEntry = cache_find(cache, key);
+    if (cacheEntry == NULL) {
         return 0;
     }
 
-    cacheEntry = cache->entries[index];
     if (cacheEntry->referenceCount != 0) {
         return 0;
     }
 
-    cacheEntry->flags |= CACHE_ENTRY_MARKED_FOR_EVICTION;
+    cache_remove(cache, cacheEntry);
 
-    cache_purge(cache);
+    // NOTE: Uninline.
+    cache_destroy_item(cache, cacheEntry);
 
     return 1;
 }
@@ -208,16 +241,15 @@ bool cache_flush(Cache* cache)
         return false;
     }
 
-    // Loop thru cache entries and mark those with no references for eviction.
-    for (int index = 0; index < cache->entriesLength; index++) {
-        CacheEntry* cacheEntry = cache->entries[index];
-        if (cacheEntry->referenceCount == 0) {
-            cacheEntry->flags |= CACHE_ENTRY_MARKED_FOR_EVICTION;
-        }
+    // Every entry with no references is in eviction heap, park them all
+    // past its end and sweep.
+    int end = cache->evictionLength;
+    for (int index = 0; index < end; index++) {
+        cache->eviction[index]->evictionIndex = -1;
     }
+    cache->evictionLength = 0;
 
-    // Sweep cache entries marked earlier.
-    cache_purge(cache);
+    cache_purge(cache, end);
 
     // Shrink cache entries array if it's too big.
     int optimalCapacity = cache->entriesLength + CACHE_ENTRIES_GROW_CAPACITY;
@@ -359,7 +391,7 @@ int cache_destroy_list(int** tagsPtr)
 // Fetches entry for the specified key into the cache.
 //
 // 0x41F0AC
-static bool cache_add(Cache* cache, int key, int* indexPtr)
+static bool cache_add(Cache* cache, int key, CacheEntry** cacheEntryPtr)
 {
     CacheEntry* cacheEntry;
 
@@ -425,25 +457,16 @@ static bool cache_add(Cache* cache, int key, int* indexPtr)
             cacheEntry->size = size;
             cacheEntry->key = key;
 
-            bool isNewKey = true;
-            if (*indexPtr < cache->entriesLength) {
-                if (key < cache->entries[*indexPtr]->key) {
-                    if (*indexPtr == 0 || key > cache->entries[*indexPtr - 1]->key) {
-                        isNewKey = false;
-                    }
-                }
-            }
-
-            if (isNewKey) {
-                if (cache_find(cache, key, indexPtr) != 3) {
-                    break;
-                }
+            if (cache_find(cache, key) != NULL) {
+                break;
             }
 
-            if (!cache_insert(cache, cacheEntry, *indexPtr)) {
+            if (!cache_insert(cache, cacheEntry)) {
                 break;
             }
 
+            *cacheEntryPtr = cacheEntry;
+
             return true;
         } while (0);
 
@@ -457,7 +480,7 @@ static bool cache_add(Cache* cache, int key, int* indexPtr)
 }
 
 // 0x41F2E8
-static bool cache_insert(Cache* cache, CacheEntry* cacheEntry, int index)
+static bool cache_insert(Cache* cache, CacheEntry* cacheEntry)
 {
     // Ensure cache have enough space for new entry.
     if (cache->entriesLength == cache->entriesCapacity - 1) {
@@ -466,58 +489,104 @@ static bool cache_insert(Cache* cache, CacheEntry* cacheEntry, int index)
         }
     }
 
-    // Move entries below insertion point.
-    memmove(&(cache->entries[index + 1]), &(cache->entries[index]), sizeof(*cache->entries) * (cache->entriesLength - index));
+    // Keep key index load factor below 1.
+    if (cache->entriesLength >= cache->bucketsLength) {
+        if (!cache_resize_buckets(cache, cache->bucketsLength * 2)) {
+            return false;
+        }
+    }
 
-    cache->entries[index] = cacheEntry;
+    cacheEntry->index = cache->entriesLength;
+    cache->entries[cache->entriesLength] = cacheEntry;
     cache->entriesLength++;
     cache->size += cacheEntry->size;
 
+    unsigned int bucket = cache_hash(cache, cacheEntry->key);
+    cacheEntry->next = cache->buckets[bucket];
+    cache->buckets[bucket] = cacheEntry;
+
+    cache_eviction_push(cache, cacheEntry);
+
     return true;
 }
 
-// Finds index for given key.
+// Removes entry from entries array, key index, and eviction heap. The entry
+// itself is not destroyed.
+static void cache_remove(Cache* cache, CacheEntry* cacheEntry)
+{
+    cache_eviction_remove(cache, cacheEntry);
+
+    CacheEntry** link = &(cache->buckets[cache_hash(cache, cacheEntry->key)]);
+    while (*link != NULL) {
+        if (*link == cacheEntry) {
+            *link = cacheEntry->next;
+            break;
+        }
+        link = &((*link)->next);
+    }
+
+    // Move last entry into the vacated slot.
+    cache->entriesLength--;
+    if (cacheEntry->index != cache->entriesLength) {
+        CacheEntry* last = cache->entries[cache->entriesLength];
+        last->index = cacheEntry->index;
+        cache->entries[cacheEntry->index] = last;
+    }
+
+    cache->size -= cacheEntry->size;
+}
+
+// Finds entry for given key.
 //
-// Returns 2 if entry already exists in cache, or 3 if entry does not exist. In
-// this case indexPtr represents insertion point.
+// Returns `NULL` if entry does not exist.
 //
 // 0x41F354
-static int cache_find(Cache* cache, int key, int* indexPtr)
+static CacheEntry* cache_find(Cache* cache, int key)
 {
-    int length = cache->entriesLength;
-    if (length == 0) {
-        *indexPtr = 0;
-        return 3;
+    CacheEntry* cacheEntry = cache->buckets[cache_hash(cache, key)];
+    while (cacheEntry != NULL) {
+        if (cacheEntry->key == key) {
+            return cacheEntry;
+        }
+        cacheEntry = cacheEntry->next;
     }
 
-    int r = length - 1;
-    int l = 0;
-    int mid;
-    int cmp;
+    return NULL;
+}
+
+static unsigned int cache_hash(Cache* cache, int key)
+{
+    unsigned int hash = (unsigned int)key;
+    hash ^= hash >> 16;
+    hash *= 0x45D9F3B;
+    hash ^= hash >> 16;
+    return hash & (cache->bucketsLength - 1);
+}
 
-    do {
-        mid = (l + r) / 2;
+static bool cache_resize_buckets(Cache* cache, int newLength)
+{
+    CacheEntry** buckets = (CacheEntry**)mem_malloc(sizeof(*buckets) * newLength);
+    if (buckets == NULL) {
+        return false;
+    }
 
-        cmp = key - cache->entries[mid]->key;
-        if (cmp == 0) {
-            *indexPtr = mid;
-            return 2;
-        }
+    if (cache->buckets != NULL) {
+        mem_free(cache->buckets);
+    }
 
-        if (cmp > 0) {
-            l = l + 1;
-        } else {
-            r = r - 1;
-        }
-    } while (r >= l);
+    memset(buckets, 0, sizeof(*buckets) * newLength);
 
-    if (cmp < 0) {
-        *indexPtr = mid;
-    } else {
-        *indexPtr = mid + 1;
+    cache->buckets = buckets;
+    cache->bucketsLength = newLength;
+
+    for (int index = 0; index < cache->entriesLength; index++) {
+        CacheEntry* cacheEntry = cache->entries[index];
+        unsigned int bucket = cache_hash(cache, cacheEntry->key);
+        cacheEntry->next = cache->buckets[bucket];
+        cache->buckets[bucket] = cacheEntry;
     }
 
-    return 3;
+    return true;
 }
 
 // 0x41F3C0
@@ -544,6 +613,9 @@ static bool cache_init_item(CacheEntry* cacheEntry)
     cacheEntry->hits = 0;
     cacheEntry->flags = 0;
     cacheEntry->mru = 0;
+    cacheEntry->index = -1;
+    cacheEntry->evictionIndex = -1;
+    cacheEntry->next = NULL;
     return true;
 }
 
@@ -572,6 +644,7 @@ static bool cache_unlock_all(Cache* cache)
         if (cacheEntry->referenceCount != 0) {
             heap_unlock(heap, cacheEntry->heapHandleIndex);
             cacheEntry->referenceCount = 0;
+            cache_eviction_push(cache, cacheEntry);
         }
     }
 
@@ -603,6 +676,11 @@ static bool cache_reset_counter(Cache* cache)
 
     // FIXME: Obviously leak `entries`.
 
+    // Eviction priorities were changed, rebuild heap.
+    for (int index = cache->evictionLength / 2 - 1; index >= 0; index--) {
+        cache_eviction_sift_down(cache, index);
+    }
+
     return true;
 }
 
@@ -622,60 +700,40 @@ static bool cache_make_room(Cache* cache, int size)
         return true;
     }
 
-    CacheEntry** entries = (CacheEntry**)mem_malloc(sizeof(*entries) * cache->entriesLength);
-    if (entries != NULL) {
-        memcpy(entries, cache->entries, sizeof(*entries) * cache->entriesLength);
-        qsort(entries, cache->entriesLength, sizeof(*entries), cache_compare_make_room);
-
-        // The sweeping threshold is 20% of cache size plus size for the new
-        // entry. Once the threshold is reached the marking process stops.
-        int threshold = size + (int)((double)cache->size * 0.2);
-
-        int accum = 0;
-        int index;
-        for (index = 0; index < cache->entriesLength; index++) {
-            CacheEntry* entry = entries[index];
-            if (entry->referenceCount == 0) {
-                if (entry->size >= threshold) {
-                    entry->flags |= CACHE_ENTRY_MARKED_FOR_EVICTION;
-
-                    // We've just found one huge entry, there is no point to
-                    // mark individual smaller entries in the code path below,
-                    // reset the accumulator to skip it entirely.
-                    accum = 0;
-                    break;
-                } else {
-                    accum += entry->size;
-
-                    if (accum >= threshold) {
-                        break;
-                    }
-                }
+    // The sweeping threshold is 20% of cache size plus size for the new
+    // entry. Once the threshold is reached the marking process stops.
+    int threshold = size + (int)((double)cache->size * 0.2);
+
+    // Unreferenced entries are popped from eviction heap in the order of
+    // their priority. Popped entries are parked right after the end of the
+    // heap so they can be put back if they are not going to be evicted.
+    int evictionLength = cache->evictionLength;
+    int accum = 0;
+    while (cache->evictionLength > 0) {
+        CacheEntry* entry = cache_eviction_pop(cache);
+        if (entry->size >= threshold) {
+            // We've just found one huge entry, there is no point to evict
+            // individual smaller entries popped earlier, return them back to
+            // the heap and evict only the huge one.
+            int end = cache->evictionLength + 1;
+            for (int index = end; index < evictionLength; index++) {
+                cache_eviction_push(cache, cache->eviction[index]);
             }
+
+            cache->eviction[cache->evictionLength] = entry;
+            evictionLength = cache->evictionLength + 1;
+            break;
         }
 
-        if (accum != 0) {
-            // The loop below assumes index to be positioned on the entry, where
-            // accumulator stopped. If we've reached the end, reposition
-            // it to the last entry.
-            if (index == cache->entriesLength) {
-                index -= 1;
-            }
+        accum += entry->size;
 
-            // Loop backwards from the point we've stopped and mark all
-            // unreferenced entries for sweeping.
-            for (; index >= 0; index--) {
-                CacheEntry* entry = entries[index];
-                if (entry->referenceCount == 0) {
-                    entry->flags |= CACHE_ENTRY_MARKED_FOR_EVICTION;
-                }
-            }
+        if (accum >= threshold) {
+            break;
         }
-
-        mem_free(entries);
     }
 
-    cache_purge(cache);
+    // Sweep all popped entries.
+    cache_purge(cache, evictionLength);
 
     if (cache->maxSize - cache->size >= size) {
         return true;
@@ -684,32 +742,19 @@ static bool cache_make_room(Cache* cache, int size)
     return false;
 }
 
+// Evicts unreferenced entries parked in eviction array right past the end of
+// the heap, up to [end]. Parked entries are no longer in the heap, so every
+// other unreferenced entry stays evictable.
+//
 // 0x41F69C
-static bool cache_purge(Cache* cache)
+static bool cache_purge(Cache* cache, int end)
 {
-    for (int index = 0; index < cache->entriesLength; index++) {
-        CacheEntry* cacheEntry = cache->entries[index];
-        if ((cacheEntry->flags & CACHE_ENTRY_MARKED_FOR_EVICTION) != 0) {
-            if (cacheEntry->referenceCount != 0) {
-                // Entry was marked for eviction but still has references,
-                // unmark it.
-                cacheEntry->flags &= ~CACHE_ENTRY_MARKED_FOR_EVICTION;
-            } else {
-                int cacheEntrySize = cacheEntry->size;
-
-                // NOTE: Uninline.
-                cache_destroy_item(cache, cacheEntry);
-
-                // Move entries up.
-                memmove(&(cache->entries[index]), &(cache->entries[index + 1]), sizeof(*cache->entries) * ((cache->entriesLength - index) - 1));
-
-                cache->entriesLength--;
-                cache->size -= cacheEntrySize;
+    for (int index = cache->evictionLength; index < end; index++) {
+        CacheEntry* cacheEntry = cache->eviction[index];
+        cache_remove(cache, cacheEntry);
 
-                // The entry was removed, compensate index.
-                index--;
-            }
-        }
+        // NOTE: Uninline.
+        cache_destroy_item(cache, cacheEntry);
     }
 
     return true;
@@ -728,6 +773,13 @@ static bool cache_resize_array(Cache* cache, int newCapacity)
     }
 
     cache->entries = entries;
+
+    CacheEntry** eviction = (CacheEntry**)mem_realloc(cache->eviction, sizeof(*cache->eviction) * newCapacity);
+    if (eviction == NULL) {
+        return false;
+    }
+
+    cache->eviction = eviction;
     cache->entriesCapacity = newCapacity;
 
     return true;
@@ -776,3 +828,99 @@ static int cache_compare_reset_counter(const void* a1, const void* a2)
         return 0;
     }
 }
+
+// Adds unreferenced entry to eviction heap.
+static void cache_eviction_push(Cache* cache, CacheEntry* cacheEntry)
+{
+    int index = cache->evictionLength;
+    cache->eviction[index] = cacheEntry;
+    cacheEntry->evictionIndex = index;
+    cache->evictionLength++;
+
+    cache_eviction_sift_up(cache, index);
+}
+
+// Removes entry with the highest eviction priority from eviction heap. The
+// removed entry is stored right past the end of the heap.
+static CacheEntry* cache_eviction_pop(Cache* cache)
+{
+    CacheEntry* cacheEntry = cache->eviction[0];
+
+    cache->evictionLength--;
+
+    CacheEntry* last = cache->eviction[cache->evictionLength];
+    cache->eviction[0] = last;
+    last->evictionIndex = 0;
+    cache_eviction_sift_down(cache, 0);
+
+    cache->eviction[cache->evictionLength] = cacheEntry;
+    cacheEntry->evictionIndex = -1;
+
+    return cacheEntry;
+}
+
+static void cache_eviction_remove(Cache* cache, CacheEntry* cacheEntry)
+{
+    int index = cacheEntry->evictionIndex;
+    if (index == -1) {
+        return;
+    }
+
+    cacheEntry->evictionIndex = -1;
+
+    cache->evictionLength--;
+    if (index == cache->evictionLength) {
+        return;
+    }
+
+    CacheEntry* last = cache->eviction[cache->evictionLength];
+    cache->eviction[index] = last;
+    last->evictionIndex = index;
+
+    cache_eviction_sift_up(cache, index);
+    cache_eviction_sift_down(cache, last->evictionIndex);
+}
+
+static void cache_eviction_sift_up(Cache* cache, int index)
+{
+    CacheEntry* cacheEntry = cache->eviction[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (cache_compare_make_room(&cacheEntry, &(cache->eviction[parent])) >= 0) {
+            break;
+        }
+
+        cache->eviction[index] = cache->eviction[parent];
+        cache->eviction[index]->evictionIndex = index;
+        index = parent;
+    }
+
+    cache->eviction[index] = cacheEntry;
+    cacheEntry->evictionIndex = index;
+}
+
+static void cache_eviction_sift_down(Cache* cache, int index)
+{
+    CacheEntry* cacheEntry = cache->eviction[index];
+    while (1) {
+        int child = index * 2 + 1;
+        if (child >= cache->evictionLength) {
+            break;
+        }
+
+        if (child + 1 < cache->evictionLength && cache_compare_make_room(&(cache->eviction[child + 1]), &(cache->eviction[child])) < 0) {
+            child += 1;
+        }
+
+        if (cache_compare_make_room(&(cache->eviction[child]), &cacheEntry) >= 0) {
+            break;
+        }
+
+        cache->eviction[index] = cache->eviction[child];
+        cache->eviction[index]->evictionIndex = index;
+        index = child;
+    }
+
+    cache->eviction[index] = cacheEntry;
+    cacheEntry->evictionIndex = index;
+}
@@ -13,6 +13,9 @@
 // The number of cache entries added when cache capacity is reached.
 #define CACHE_ENTRIES_GROW_CAPACITY 50
 
+// The initial number of buckets in key index, must be power of two.
+#define CACHE_BUCKETS_INITIAL_CAPACITY 256
+
 typedef enum CacheEntryFlags {
     // Specifies that cache entry has no references as should be evicted during
     // the next sweep operation.
@@ -46,6 +49,16 @@ typedef struct CacheEntry {
     unsigned int mru;
 
     int heapHandleIndex;
+
+    // Position of this entry in `entries` array.
+    int index;
+
+    // Position of this entry in `eviction` heap, or -1 if entry is
+    // referenced.
+    int evictionIndex;
+
+    // Next entry in the same key index bucket.
+    struct CacheEntry* next;
 } CacheEntry;
 
 typedef struct Cache {
@@ -64,9 +77,23 @@ typedef struct Cache {
     // Total number of hits during cache lifetime.
     unsigned int hits;
 
-    // List of cache entries.
+    // List of cache entries (unordered).
     CacheEntry** entries;
 
+    // Key index, `bucketsLength` chains of entries linked via `next`.
+    CacheEntry** buckets;
+
+    // The number of buckets in `buckets` array, always power of two.
+    int bucketsLength;
+
+    // Binary heap of unreferenced entries ordered by eviction priority (least
+    // hits first, then least recently used). Has the same capacity as
+    // `entries`.
+    CacheEntry** eviction;
+
+    // The number of entries in `eviction` heap.
+    int evictionLength;
+
     CacheSizeProc* sizeProc;
     CacheReadProc* readProc;
     CacheFreeProc* freeProc;
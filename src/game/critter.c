@@ -1,5 +1,6 @@
 #include "game/critter.h"
 
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -99,6 +100,17 @@ static int pc_kill_counts[KILL_TYPE_COUNT];
 // 0x56BF20
 static int old_rad_level;
 
+// Layout of [CritterProtoData] in proto and save files.
+static const db_field critter_data_fields[] = {
+    { 4, 1, offsetof(CritterProtoData, flags) },
+    { 4, SAVEABLE_STAT_COUNT, offsetof(CritterProtoData, baseStats) },
+    { 4, SAVEABLE_STAT_COUNT, offsetof(CritterProtoData, bonusStats) },
+    { 4, SKILL_COUNT, offsetof(CritterProtoData, skills) },
+    { 4, 1, offsetof(CritterProtoData, bodyType) },
+    { 4, 1, offsetof(CritterProtoData, experience) },
+    { 4, 1, offsetof(CritterProtoData, killType) },
+};
+
 // 0x427860
 int critter_init()
 {
@@ -168,6 +180,7 @@ int critter_save(DB_FILE* stream)
 void critter_copy(CritterProtoData* dest, CritterProtoData* src)
 {
     memcpy(dest, src, sizeof(CritterProtoData));
+    stat_cache_invalidate();
 }
 
 // 0x4279B8
@@ -762,6 +775,7 @@ void critter_kill(Object* critter, int anim, bool refresh_window)
 
     if (critter->pid != 16777265 && critter->pid != 16777266 && critter->pid != 16777224) {
         critter->flags |= OBJECT_NO_BLOCK;
+        obj_blocking_changed(critter);
         if ((critter->flags & OBJECT_FLAT) == 0) {
             obj_toggle_flat(critter, &tempRect);
         }
@@ -940,6 +954,8 @@ int pc_load_data(const char* path)
     proto->critter.data.experience = 0;
     proto->critter.data.killType = 0;
 
+    stat_cache_invalidate();
+
     db_fclose(stream);
     return 0;
 }
@@ -947,13 +963,9 @@ int pc_load_data(const char* path)
 // 0x4286DC
 int critter_read_data(DB_FILE* stream, CritterProtoData* critterData)
 {
-    if (db_freadInt(stream, &(critterData->flags)) == -1) return -1;
-    if (db_freadIntCount(stream, critterData->baseStats, SAVEABLE_STAT_COUNT) == -1) return -1;
-    if (db_freadIntCount(stream, critterData->bonusStats, SAVEABLE_STAT_COUNT) == -1) return -1;
-    if (db_freadIntCount(stream, critterData->skills, SKILL_COUNT) == -1) return -1;
-    if (db_freadInt(stream, &(critterData->bodyType)) == -1) return -1;
-    if (db_freadInt(stream, &(critterData->experience)) == -1) return -1;
-    if (db_freadInt(stream, &(critterData->killType)) == -1) return -1;
+    if (db_freadRecord(stream, critterData, critter_data_fields, sizeof(critter_data_fields) / sizeof(critter_data_fields[0])) == -1) return -1;
+
+    stat_cache_invalidate();
 
     return 0;
 }
@@ -1017,13 +1029,7 @@ int pc_save_data(const char* path)
 // 0x4288BC
 int critter_write_data(DB_FILE* stream, CritterProtoData* critterData)
 {
-    if (db_fwriteInt(stream, critterData->flags) == -1) return -1;
-    if (db_fwriteIntCount(stream, critterData->baseStats, SAVEABLE_STAT_COUNT) == -1) return -1;
-    if (db_fwriteIntCount(stream, critterData->bonusStats, SAVEABLE_STAT_COUNT) == -1) return -1;
-    if (db_fwriteIntCount(stream, critterData->skills, SKILL_COUNT) == -1) return -1;
-    if (db_fwriteInt(stream, critterData->bodyType) == -1) return -1;
-    if (db_fwriteInt(stream, critterData->experience) == -1) return -1;
-    if (db_fwriteInt(stream, critterData->killType) == -1) return -1;
+    if (db_fwriteRecord(stream, critterData, critter_data_fields, sizeof(critter_data_fields) / sizeof(critter_data_fields[0])) == -1) return -1;
 
     return 0;
 }
@@ -53,6 +53,7 @@
 #include "int/window.h"
 #include "plib/color/color.h"
 #include "plib/db/db.h"
+#include "plib/db/lzss.h"
 #include "plib/gnw/debug.h"
 #include "plib/gnw/gnw.h"
 #include "plib/gnw/grbuf.h"
@@ -1165,6 +1166,8 @@ int game_quit_with_confirm()
 static int game_init_databases()
 {
     int hashing;
+    int mapping;
+    int checkLzss;
     char* main_file_name;
     char* patch_file_name;
 
@@ -1176,6 +1179,18 @@ static int game_init_databases()
         db_enable_hash_table();
     }
 
+    mapping = 0;
+    config_get_value(&game_config, GAME_CONFIG_SYSTEM_KEY, GAME_CONFIG_MAPPING_KEY, &mapping);
+    if (mapping != 0) {
+        db_enable_mapping();
+    }
+
+    checkLzss = 0;
+    config_get_value(&game_config, GAME_CONFIG_DEBUG_KEY, GAME_CONFIG_CHECK_LZSS_KEY, &checkLzss);
+    if (checkLzss != 0) {
+        lzss_enable_check();
+    }
+
     config_get_string(&game_config, GAME_CONFIG_SYSTEM_KEY, GAME_CONFIG_MASTER_DAT_KEY, &main_file_name);
     if (*main_file_name == '\0') {
         main_file_name = NULL;
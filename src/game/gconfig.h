@@ -27,6 +27,7 @@
 #define GAME_CONFIG_COLOR_CYCLING_KEY "color_cycling"
 #define GAME_CONFIG_CYCLE_SPEED_FACTOR_KEY "cycle_speed_factor"
 #define GAME_CONFIG_HASHING_KEY "hashing"
+#define GAME_CONFIG_MAPPING_KEY "mapping"
 #define GAME_CONFIG_SPLASH_KEY "splash"
 #define GAME_CONFIG_FREE_SPACE_KEY "free_space"
 #define GAME_CONFIG_TIMES_RUN_KEY "times_run"
@@ -69,6 +70,9 @@
 #define GAME_CONFIG_SHOW_SCRIPT_MESSAGES_KEY "show_script_messages"
 #define GAME_CONFIG_SHOW_LOAD_INFO_KEY "show_load_info"
 #define GAME_CONFIG_OUTPUT_MAP_DATA_INFO_KEY "output_map_data_info"
+#define GAME_CONFIG_CHECK_STAT_CACHE_KEY "check_stat_cache"
+#define GAME_CONFIG_CHECK_OBJ_POOL_KEY "check_obj_pool"
+#define GAME_CONFIG_CHECK_LZSS_KEY "check_lzss"
 #define GAME_CONFIG_EXECUTABLE_KEY "executable"
 #define GAME_CONFIG_OVERRIDE_LIBRARIAN_KEY "override_librarian"
 #define GAME_CONFIG_USE_ART_NOT_PROTOS_KEY "use_art_not_protos"
@@ -3503,6 +3503,10 @@ static void talk_to_display_frame(Art* headFrm, int frame)
             tile_refresh_display();
         }
 
+        // Can run from [head_bk], when rects requested earlier in the same
+        // pass over background processes are not rendered yet.
+        tile_flush_refresh_rects();
+
         unsigned char* src = win_get_buf(display_win);
         buf_to_buf(
             src + ((scr_size.lry - scr_size.uly + 1 - 332) / 2) * (GAME_DIALOG_WINDOW_WIDTH) + (GAME_DIALOG_WINDOW_WIDTH - 388) / 2,
@@ -13,6 +13,7 @@
 #include "game/gsound.h"
 #include "game/moviefx.h"
 #include "game/palette.h"
+#include "game/tile.h"
 #include "int/movie.h"
 #include "int/window.h"
 #include "plib/color/color.h"
@@ -112,6 +113,8 @@ int gmovie_play(int game_movie, int game_movie_flags)
         return -1;
     }
 
+    tile_flush_refresh_rects();
+
     if ((game_movie_flags & GAME_MOVIE_FADE_IN) != 0) {
         palette_fade_to(black_palette);
     }
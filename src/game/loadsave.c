@@ -1550,6 +1550,8 @@ static int LoadSlot(int slot)
 
     loadingGame = 1;
 
+    unsigned int loadStart = get_time();
+
     sprintf(gmpath, "%s\\%s%.2d\\", "SAVEGAME", "SLOT", slot_cursor + 1);
     strcat(gmpath, "SAVE.DAT");
 
@@ -1593,6 +1595,12 @@ static int LoadSlot(int slot)
     debug_printf("LOADSAVE: Total load data read: %ld bytes.\n", db_ftell(flptr));
     db_fclose(flptr);
 
+    // Includes loading the map the game was saved on, which is also logged
+    // on its own with map data info.
+    debug_printf("LOADSAVE: Load time: %u ms.\n", elapsed_tocks(get_time(), loadStart));
+
+    map_validate_data_info();
+
     sprintf(str, "%s\\", "MAPS");
     MapDirErase(str, "BAK");
     proto_dude_update_gender();
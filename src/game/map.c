@@ -1,6 +1,7 @@
 #include "game/map.h"
 
 #include <direct.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -30,7 +31,9 @@
 #include "game/textobj.h"
 #include "game/tile.h"
 #include "game/worldmap.h"
+#include "int/intrpret.h"
 #include "plib/color/color.h"
+#include "plib/db/lzss.h"
 #include "plib/gnw/debug.h"
 #include "plib/gnw/gnw.h"
 #include "plib/gnw/grbuf.h"
@@ -42,8 +45,6 @@
 static int map_age_dead_critters();
 static void map_match_map_number();
 static void map_display_draw(Rect* rect);
-static void map_scroll_refresh_game(Rect* rect);
-static void map_scroll_refresh_mapper(Rect* rect);
 static int map_allocate_global_vars(int count);
 static void map_free_global_vars();
 static int map_load_global_vars(DB_FILE* stream);
@@ -56,6 +57,7 @@ static void square_reset();
 static int square_load(DB_FILE* stream, int a2);
 static int map_write_MapData(MapHeader* ptr, DB_FILE* stream);
 static int map_read_MapData(MapHeader* ptr, DB_FILE* stream);
+static void map_output_data_info(unsigned int loadTime);
 
 // 0x4735CE
 static const short city_vs_city_idx_table[MAP_COUNT][5] = {
@@ -203,9 +205,6 @@ char byte_50B058[] = "";
 // 0x50B30C
 char _aErrorF2[] = "ERROR! F2";
 
-// 0x505ACC
-static IsoWindowRefreshProc* map_scroll_refresh = map_scroll_refresh_game;
-
 // 0x505AD0
 static int map_data_elev_flags[ELEVATION_COUNT] = {
     2,
@@ -263,6 +262,14 @@ TileData* square[ELEVATION_COUNT];
 // 0x6303C8
 int display_win;
 
+// Layout of [MapHeader] in map files, see [map_read_MapData].
+static const db_field map_data_fields[] = {
+    { 4, 1, offsetof(MapHeader, version) },
+    { 1, 16, offsetof(MapHeader, name) },
+    { 4, 10, offsetof(MapHeader, enteringTile) },
+    { 4, 44, offsetof(MapHeader, field_3C) },
+};
+
 // 0x4738E8
 int iso_init()
 {
@@ -365,12 +372,6 @@ void iso_exit()
 // 0x473BD0
 void map_init()
 {
-    char* executable;
-    config_get_string(&game_config, GAME_CONFIG_SYSTEM_KEY, "executable", &executable);
-    if (stricmp(executable, "mapper") == 0) {
-        map_scroll_refresh = map_scroll_refresh_mapper;
-    }
-
     if (message_init(&map_msg_file)) {
         char path[FILENAME_MAX];
         sprintf(path, "%smap.msg", msg_path);
@@ -448,6 +449,9 @@ int map_set_elevation(int elevation)
     gmouse_set_cursor(MOUSE_CURSOR_NONE);
     map_elevation = elevation;
 
+    // Window still shows previous elevation.
+    tile_invalidate_buf();
+
     register_clear(obj_dude);
     dude_stand(obj_dude, obj_dude->rotation, obj_dude->fid);
     partyMemberSyncPosition();
@@ -698,76 +702,12 @@ int map_scroll(int dx, int dy)
         return -1;
     }
 
-    if (tile_set_center(newCenterTile, 0) == -1) {
+    // Window contents are shifted and only the hexes which scrolled into
+    // view are rendered, see [tile_set_center].
+    if (tile_set_center(newCenterTile, TILE_SET_CENTER_REFRESH_WINDOW) == -1) {
         return -1;
     }
 
-    Rect r1;
-    rectCopy(&r1, &map_display_rect);
-
-    Rect r2;
-    rectCopy(&r2, &r1);
-
-    int width = scr_size.lrx - scr_size.ulx + 1;
-    int pitch = width;
-    int height = scr_size.lry - scr_size.uly - 99;
-
-    if (screenDx != 0) {
-        width -= 32;
-    }
-
-    if (screenDy != 0) {
-        height -= 24;
-    }
-
-    if (screenDx < 0) {
-        r2.lrx = r2.ulx - screenDx;
-    } else {
-        r2.ulx = r2.lrx - screenDx;
-    }
-
-    unsigned char* src;
-    unsigned char* dest;
-    int step;
-    if (screenDy < 0) {
-        r1.lry = r1.uly - screenDy;
-        src = display_buf + pitch * (height - 1);
-        dest = display_buf + pitch * (scr_size.lry - scr_size.uly - 100);
-        if (screenDx < 0) {
-            dest -= screenDx;
-        } else {
-            src += screenDx;
-        }
-        step = -pitch;
-    } else {
-        r1.uly = r1.lry - screenDy;
-        dest = display_buf;
-        src = display_buf + pitch * screenDy;
-
-        if (screenDx < 0) {
-            dest -= screenDx;
-        } else {
-            src += screenDx;
-        }
-        step = pitch;
-    }
-
-    for (int y = 0; y < height; y++) {
-        memmove(dest, src, width);
-        dest += step;
-        src += step;
-    }
-
-    if (screenDx != 0) {
-        map_scroll_refresh(&r2);
-    }
-
-    if (screenDy != 0) {
-        map_scroll_refresh(&r1);
-    }
-
-    win_draw(display_win);
-
     return 0;
 }
 
@@ -887,6 +827,9 @@ int map_load_file(DB_FILE* stream)
     const char* error;
 
     map_save_in_game(true);
+
+    unsigned int loadStart = get_time();
+
     gsound_background_play("wind2", 12, 13, 16);
     map_disable_bk_processes();
     partyMemberPrepLoad();
@@ -894,6 +837,9 @@ int map_load_file(DB_FILE* stream)
     gmouse_set_cursor(MOUSE_CURSOR_WAIT_PLANET);
     db_register_callback(gmouse_bk_process, 8192);
     tile_disable_refresh();
+
+    // Window still shows previous map.
+    tile_invalidate_buf();
     anim_stop();
     scr_disable();
 
@@ -1042,6 +988,8 @@ int map_load_file(DB_FILE* stream)
     gmouse_enable_scrolling();
     gmouse_set_cursor(MOUSE_CURSOR_NONE);
 
+    map_output_data_info(elapsed_tocks(get_time(), loadStart));
+
     return rc;
 }
 
@@ -1559,41 +1507,6 @@ static void map_display_draw(Rect* rect)
     win_draw_rect(display_win, rect);
 }
 
-// 0x475C50
-static void map_scroll_refresh_game(Rect* rect)
-{
-    Rect clampedDirtyRect;
-    if (rect_inside_bound(rect, &map_display_rect, &clampedDirtyRect) == -1) {
-        return;
-    }
-
-    square_render_floor(&clampedDirtyRect, map_elevation);
-    grid_render(&clampedDirtyRect, map_elevation);
-    obj_render_pre_roof(&clampedDirtyRect, map_elevation);
-    square_render_roof(&clampedDirtyRect, map_elevation);
-    obj_render_post_roof(&clampedDirtyRect, map_elevation);
-}
-
-// 0x475CB0
-static void map_scroll_refresh_mapper(Rect* rect)
-{
-    Rect clampedDirtyRect;
-    if (rect_inside_bound(rect, &map_display_rect, &clampedDirtyRect) == -1) {
-        return;
-    }
-
-    buf_fill(display_buf + clampedDirtyRect.uly * (scr_size.lrx - scr_size.ulx + 1) + clampedDirtyRect.ulx,
-        clampedDirtyRect.lrx - clampedDirtyRect.ulx + 1,
-        clampedDirtyRect.lry - clampedDirtyRect.uly + 1,
-        scr_size.lrx - scr_size.ulx + 1,
-        0);
-    square_render_floor(&clampedDirtyRect, map_elevation);
-    grid_render(&clampedDirtyRect, map_elevation);
-    obj_render_pre_roof(&clampedDirtyRect, map_elevation);
-    square_render_roof(&clampedDirtyRect, map_elevation);
-    obj_render_post_roof(&clampedDirtyRect, map_elevation);
-}
-
 // 0x475D50
 static int map_allocate_global_vars(int count)
 {
@@ -1768,19 +1681,7 @@ static int square_load(DB_FILE* stream, int flags)
 // 0x476120
 static int map_write_MapData(MapHeader* ptr, DB_FILE* stream)
 {
-    if (db_fwriteInt(stream, ptr->version) == -1) return -1;
-    if (db_fwriteByteCount(stream, ptr->name, 16) == -1) return -1;
-    if (db_fwriteInt(stream, ptr->enteringTile) == -1) return -1;
-    if (db_fwriteInt(stream, ptr->enteringElevation) == -1) return -1;
-    if (db_fwriteInt(stream, ptr->enteringRotation) == -1) return -1;
-    if (db_fwriteInt(stream, ptr->localVariablesCount) == -1) return -1;
-    if (db_fwriteInt(stream, ptr->scriptIndex) == -1) return -1;
-    if (db_fwriteInt(stream, ptr->flags) == -1) return -1;
-    if (db_fwriteInt(stream, ptr->darkness) == -1) return -1;
-    if (db_fwriteInt(stream, ptr->globalVariablesCount) == -1) return -1;
-    if (db_fwriteInt(stream, ptr->field_34) == -1) return -1;
-    if (db_fwriteInt(stream, ptr->lastVisitTime) == -1) return -1;
-    if (db_fwriteIntCount(stream, ptr->field_3C, 44) == -1) return -1;
+    if (db_fwriteRecord(stream, ptr, map_data_fields, sizeof(map_data_fields) / sizeof(map_data_fields[0])) == -1) return -1;
 
     return 0;
 }
@@ -1788,19 +1689,94 @@ static int map_write_MapData(MapHeader* ptr, DB_FILE* stream)
 // 0x47621C
 static int map_read_MapData(MapHeader* ptr, DB_FILE* stream)
 {
-    if (db_freadInt(stream, &(ptr->version)) == -1) return -1;
-    if (db_freadByteCount(stream, ptr->name, 16) == -1) return -1;
-    if (db_freadInt(stream, &(ptr->enteringTile)) == -1) return -1;
-    if (db_freadInt(stream, &(ptr->enteringElevation)) == -1) return -1;
-    if (db_freadInt(stream, &(ptr->enteringRotation)) == -1) return -1;
-    if (db_freadInt(stream, &(ptr->localVariablesCount)) == -1) return -1;
-    if (db_freadInt(stream, &(ptr->scriptIndex)) == -1) return -1;
-    if (db_freadInt(stream, &(ptr->flags)) == -1) return -1;
-    if (db_freadInt(stream, &(ptr->darkness)) == -1) return -1;
-    if (db_freadInt(stream, &(ptr->globalVariablesCount)) == -1) return -1;
-    if (db_freadInt(stream, &(ptr->field_34)) == -1) return -1;
-    if (db_freadInt(stream, &(ptr->lastVisitTime)) == -1) return -1;
-    if (db_freadIntCount(stream, ptr->field_3C, 44) == -1) return -1;
+    if (db_freadRecord(stream, ptr, map_data_fields, sizeof(map_data_fields) / sizeof(map_data_fields[0])) == -1) return -1;
 
     return 0;
 }
+
+// Size of buffer passed to [MapDataInfoStatsProc]s. The longest report,
+// [obj_pool_stats], takes at most 221 bytes with every number at its widest.
+#define MAP_DATA_INFO_STATS_SIZE 512
+
+// Prints statistics of a subsystem into [dest], which is at least
+// [MAP_DATA_INFO_STATS_SIZE] bytes long.
+typedef bool MapDataInfoStatsProc(char* dest);
+
+// Returns `false` if incrementally maintained data of a subsystem differs
+// from a full rebuild.
+typedef bool MapDataInfoValidateProc();
+
+typedef struct MapDataInfoValidator {
+    MapDataInfoValidateProc* proc;
+    // Logged when [proc] fails.
+    const char* error;
+} MapDataInfoValidator;
+
+// Statistics logged by [map_output_data_info], in order.
+static MapDataInfoStatsProc* const map_data_info_stats[] = {
+    path_cache_stats,
+    scr_index_stats,
+    scr_spatial_stats,
+    proto_index_stats,
+    floor_cache_stats,
+    tile_refresh_stats,
+    interpretProgramImageStats,
+    obj_pool_stats,
+    tile_scroll_stats,
+    lzss_stats,
+};
+
+// Consistency checks run by [map_validate_data_info].
+static const MapDataInfoValidator map_data_info_validators[] = {
+    { obj_blocking_validate, "blocking bitmaps are out of sync" },
+    { scr_index_validate, "script index is out of sync" },
+    { proto_index_validate, "proto index is out of sync" },
+    { obj_light_validate, "tile light levels are out of sync" },
+};
+
+// Logs statistics of map related caches to debug output and cross-checks
+// incrementally maintained indexes against full rebuilds when
+// `output_map_data_info` is set in `debug` section of game config. Called
+// after every map load, so counters cover play since the previous load.
+// [loadTime] is time spent loading the map (without saving the previous one).
+static void map_output_data_info(unsigned int loadTime)
+{
+    bool enabled = false;
+    configGetBool(&game_config, GAME_CONFIG_DEBUG_KEY, GAME_CONFIG_OUTPUT_MAP_DATA_INFO_KEY, &enabled);
+    if (!enabled) {
+        return;
+    }
+
+    char stats[MAP_DATA_INFO_STATS_SIZE];
+
+    debug_printf("\nMAP: Data info for %s:\n", map_data.name);
+    debug_printf("Map load: %u ms.\n", loadTime);
+
+    for (int index = 0; index < sizeof(map_data_info_stats) / sizeof(map_data_info_stats[0]); index++) {
+        if (map_data_info_stats[index](stats)) {
+            debug_printf("%s", stats);
+        }
+    }
+
+    map_validate_data_info();
+}
+
+// Cross-checks incrementally maintained indexes against full rebuilds when
+// `output_map_data_info` is set in `debug` section of game config. Besides
+// map loads, called after a savegame is loaded, since savegame handlers which
+// run after the map (`scr_game_load2`, `partyMemberLoad`) still change
+// scripts and objects.
+void map_validate_data_info()
+{
+    bool enabled = false;
+    configGetBool(&game_config, GAME_CONFIG_DEBUG_KEY, GAME_CONFIG_OUTPUT_MAP_DATA_INFO_KEY, &enabled);
+    if (!enabled) {
+        return;
+    }
+
+    for (int index = 0; index < sizeof(map_data_info_validators) / sizeof(map_data_info_validators[0]); index++) {
+        if (!map_data_info_validators[index].proc()) {
+            debug_printf("\nError: map_validate_data_info: %s", map_data_info_validators[index].error);
+        }
+    }
+}
@@ -121,5 +121,6 @@ int map_save_file(DB_FILE* stream);
 int map_save_in_game(bool a1);
 void map_setup_paths();
 int map_match_map_name(const char* name);
+void map_validate_data_info();
 
 #endif /* FALLOUT_GAME_MAP_H_ */
@@ -1,6 +1,9 @@
 #include "game/object.h"
 
 #include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "game/anim.h"
@@ -27,6 +30,96 @@
 #include "plib/gnw/memory.h"
 #include "plib/gnw/svga.h"
 
+// The number of words in per-elevation tile occupancy bitset.
+#define OBJECT_TABLE_OCCUPIED_LENGTH ((HEX_GRID_SIZE + 31) / 32)
+
+// Extra bit in [ObjectListNode.blocking] denoting object was accounted in
+// [obj_multihex_footprint].
+#define OBJECT_BLOCKING_MULTIHEX 0x100
+
+// The number of hexes around light source (36 in every direction) which can
+// be lit by it, see [light_offsets].
+#define OBJECT_LIGHT_OFFSETS (ROTATION_COUNT * 36)
+
+#define OBJECT_LIGHTS_INITIAL_CAPACITY 64
+
+#define OBJECT_POOL_OBJECTS_PER_SLAB 256
+#define OBJECT_POOL_NODES_PER_SLAB 1024
+
+// Byte freed pool items are filled with when [obj_pool_check] is enabled.
+#define OBJECT_POOL_FREE_FILL 0xDD
+
+// Smallest buffer handed out by [obj_scratch_alloc], in bytes.
+#define OBJECT_SCRATCH_MIN_SIZE 256
+
+// Number of released scratch buffers kept for reuse.
+#define OBJECT_SCRATCH_CACHE_SIZE 4
+
+// Contribution of a single light source to tile light levels, an entry of
+// [obj_lights].
+typedef struct ObjectLight {
+    // Light source, or `NULL` if this entry is unused.
+    Object* obj;
+
+    // Hex and elevation light source was at.
+    int tile;
+    int elevation;
+
+    // Intensity added to [tile] itself.
+    int intensity;
+
+    // Intensity of surrounding hexes is [falloffIntensity] minus [falloffStep]
+    // for every hex of distance from [tile].
+    int falloffIntensity;
+    int falloffStep;
+
+    int distance;
+
+    // Bit `rotation * 36 + index` is set if hex at
+    // `light_offsets[tile & 1][rotation][index]` was lit.
+    unsigned int lit[(OBJECT_LIGHT_OFFSETS + 31) / 32];
+
+    // Screen area covered by the light and objects it touched.
+    Rect rect;
+} ObjectLight;
+
+// Header of a block of [ObjectPool] items, items follow it.
+// Header of a slab, followed by [ObjectPool.slabLength] items and as many
+// free flags (kept up to date only when [obj_pool_check] is enabled).
+typedef struct ObjectPoolSlab {
+    struct ObjectPoolSlab* next;
+} ObjectPoolSlab;
+
+// Fixed size allocator for [Object]s and [ObjectListNode]s.
+//
+// Items are carved from slabs of [slabLength] and recycled through a free
+// list threaded through their first bytes. Slabs are only released with the
+// subsystem, so map changes do not return thousands of small blocks to the
+// heap just to allocate them again.
+typedef struct ObjectPool {
+    const char* name;
+
+    // Size of an item rounded up to pointer alignment.
+    size_t itemSize;
+    int slabLength;
+    ObjectPoolSlab* slabs;
+    void* freeList;
+    int slabCount;
+
+    // Number of items handed out and not yet freed.
+    int used;
+    int peak;
+
+    // Number of [obj_pool_alloc] calls since last [obj_pool_stats].
+    int allocations;
+} ObjectPool;
+
+// Header preceding every [obj_scratch_alloc] buffer.
+typedef union ObjectScratchHeader {
+    size_t size;
+    void* align;
+} ObjectScratchHeader;
+
 static int obj_read_obj(Object* obj, DB_FILE* stream);
 static int obj_load_func(DB_FILE* stream);
 static void obj_fix_combat_cid_for_dude();
@@ -52,8 +145,34 @@ static void obj_destroy_object_node(ObjectListNode** nodePtr);
 static int obj_node_ptr(Object* obj, ObjectListNode** out_node, ObjectListNode** out_prev_node);
 static void obj_insert(ObjectListNode* ptr);
 static int obj_remove(ObjectListNode* a1, ObjectListNode* a2);
+static void obj_unlink(ObjectListNode* node, ObjectListNode* previousNode);
+static int obj_blocking_mask(Object* obj);
+static void obj_blocking_adjust(Object* obj, int mask, int delta);
+static void obj_blocking_count_adjust(int blocking, int elevation, int tile, int delta);
+static void obj_blocking_epoch_bump(Object* obj);
+static bool obj_tile_occupied(int tile, int elevation);
+static int obj_next_occupied_tile(int tile, int elevation);
+static ObjectListNode* obj_tile_first_node(int tile);
+static ObjectListNode* obj_tile_next_node(ObjectListNode* node);
 static int obj_connect_to_tile(ObjectListNode* node, int tile_index, int elev, Rect* rect);
 static int obj_adjust_light(Object* obj, int a2, Rect* rect);
+static int obj_light_compute(Object* obj, ObjectLight* light);
+static void obj_light_apply(ObjectLight* light, AdjustLightIntensityProc* adjustLightIntensity);
+static unsigned int obj_light_hash(Object* obj);
+static ObjectLight* obj_light_find(Object* obj);
+static ObjectLight* obj_light_insert(ObjectLight* light);
+static void obj_light_remove(ObjectLight* light);
+static int obj_lights_grow();
+static void obj_lights_clear();
+static void obj_lights_free();
+static void* obj_pool_alloc(ObjectPool* pool);
+static void obj_pool_free(ObjectPool* pool, void* item);
+static unsigned char* obj_pool_free_flag(ObjectPool* pool, void* item);
+static void obj_pool_fill(ObjectPool* pool);
+static void obj_pool_release(ObjectPool* pool);
+static void* obj_scratch_alloc(size_t size);
+static void obj_scratch_free(void* ptr);
+static void obj_scratch_exit();
 static void obj_render_outline(Object* object, Rect* rect);
 static void obj_render_object(Object* object, Rect* rect, int light);
 static int obj_preload_sort(const void* a1, const void* a2);
@@ -218,10 +337,25 @@ static Object* outlinedObjects[100];
 // 0x6382E0
 static Rect buf_rect;
 
-// Contains objects that are bounded to tiles.
+// Contains objects that are bounded to tiles, split by elevation.
 //
 // 0x6382F0
-static ObjectListNode* objectTable[HEX_GRID_SIZE];
+static ObjectListNode* objectTable[ELEVATION_COUNT][HEX_GRID_SIZE];
+
+// Bitsets of tiles which have objects on every elevation.
+static unsigned int objectTableOccupied[ELEVATION_COUNT][OBJECT_TABLE_OCCUPIED_LENGTH];
+
+// Number of multihex objects in the vicinity of every tile. Tiles with zero
+// count do not need neighbourhood scan in [obj_blocking_at].
+static unsigned short obj_multihex_footprint[ELEVATION_COUNT][HEX_GRID_SIZE];
+
+// Number of objects blocking movement, sight, and projectiles at every tile,
+// see [obj_blocking_mask]. Multihex objects are counted in 3x3 block around
+// their tile (except for sight which is checked on object's tile only).
+static unsigned short obj_blocking_counts[OBJECT_BLOCKING_COUNT][ELEVATION_COUNT][HEX_GRID_SIZE];
+
+// Bitsets of tiles with non-zero [obj_blocking_counts].
+static unsigned int obj_blocking_bits[OBJECT_BLOCKING_COUNT][ELEVATION_COUNT][OBJECT_TABLE_OCCUPIED_LENGTH];
 
 // 0x65F3F0
 static Rect updateAreaPixelBounds;
@@ -261,6 +395,53 @@ static char obj_seen_check[5001];
 // 0x6609A5
 static char obj_seen[5001];
 
+// Blocking epoch of every elevation, incremented each time blocking objects
+// on that elevation are added, removed, moved, or change their blocking
+// flags. Used by pathfinding to detect stale results.
+static unsigned int obj_blocking_epochs[ELEVATION_COUNT];
+
+// Open-addressing table (linear probing) of lights currently added to tile
+// light levels keyed by light source. Lights are removed by replaying their
+// records, so light levels do not drift when occluders change between
+// turning light on and off.
+static ObjectLight* obj_lights = NULL;
+
+// Number of entries in [obj_lights], always a power of two.
+static int obj_lights_capacity = 0;
+
+// Number of used entries in [obj_lights].
+static int obj_lights_length = 0;
+
+static ObjectPool obj_object_pool = {
+    "objects",
+    (sizeof(Object) + sizeof(void*) - 1) / sizeof(void*) * sizeof(void*),
+    OBJECT_POOL_OBJECTS_PER_SLAB,
+};
+
+static ObjectPool obj_node_pool = {
+    "nodes",
+    (sizeof(ObjectListNode) + sizeof(void*) - 1) / sizeof(void*) * sizeof(void*),
+    OBJECT_POOL_NODES_PER_SLAB,
+};
+
+// When enabled freed pool items are poisoned and verified on reuse, and frees
+// of foreign or already freed items are reported instead of corrupting the
+// free list. Controlled by `check_obj_pool` in debug config section.
+static bool obj_pool_check = false;
+
+// Duration of last [obj_remove_all] in milliseconds.
+static unsigned int obj_remove_all_time = 0;
+
+// Released [obj_scratch_alloc] buffers, or `NULL` for empty slots.
+static ObjectScratchHeader* obj_scratch_cache[OBJECT_SCRATCH_CACHE_SIZE];
+
+// Layout of [Object] in map and save files, see [obj_read_obj].
+static const db_field obj_fields[] = {
+    { 4, 11, offsetof(Object, id) },
+    { 4, 6, offsetof(Object, pid) },
+    { 4, 1, offsetof(Object, field_80) },
+};
+
 // 0x47A590
 int obj_init(unsigned char* buf, int width, int height, int pitch)
 {
@@ -324,6 +505,10 @@ int obj_init(unsigned char* buf, int width, int height, int pitch)
     buf_size = height * width;
     buf_full = pitch;
 
+    bool checkPool = false;
+    configGetBool(&game_config, GAME_CONFIG_DEBUG_KEY, GAME_CONFIG_CHECK_OBJ_POOL_KEY, &checkPool);
+    obj_pool_set_check(checkPool);
+
     dudeFid = art_id(OBJ_TYPE_CRITTER, art_vault_guy_num, 0, 0, 0);
     obj_new(&obj_dude, dudeFid, 0x1000000);
 
@@ -358,6 +543,7 @@ void obj_reset()
         obj_remove_all();
         memset(obj_seen, 0, 5001);
         light_reset();
+        obj_lights_clear();
     }
 }
 
@@ -375,6 +561,12 @@ void obj_exit()
         obj_blend_table_exit();
 
         light_exit();
+        obj_lights_free();
+
+        // Objects which are still alive (normally none) keep their slabs.
+        obj_pool_release(&obj_object_pool);
+        obj_pool_release(&obj_node_pool);
+        obj_scratch_exit();
 
         // NOTE: Uninline.
         obj_render_table_exit();
@@ -389,27 +581,9 @@ void obj_exit()
 // 0x47A904
 static int obj_read_obj(Object* obj, DB_FILE* stream)
 {
-    int field_74;
-
-    if (db_freadInt(stream, &(obj->id)) == -1) return -1;
-    if (db_freadInt(stream, &(obj->tile)) == -1) return -1;
-    if (db_freadInt(stream, &(obj->x)) == -1) return -1;
-    if (db_freadInt(stream, &(obj->y)) == -1) return -1;
-    if (db_freadInt(stream, &(obj->sx)) == -1) return -1;
-    if (db_freadInt(stream, &(obj->sy)) == -1) return -1;
-    if (db_freadInt(stream, &(obj->frame)) == -1) return -1;
-    if (db_freadInt(stream, &(obj->rotation)) == -1) return -1;
-    if (db_freadInt(stream, &(obj->fid)) == -1) return -1;
-    if (db_freadInt(stream, &(obj->flags)) == -1) return -1;
-    if (db_freadInt(stream, &(obj->elevation)) == -1) return -1;
-    if (db_freadInt(stream, &(obj->pid)) == -1) return -1;
-    if (db_freadInt(stream, &(obj->cid)) == -1) return -1;
-    if (db_freadInt(stream, &(obj->lightDistance)) == -1) return -1;
-    if (db_freadInt(stream, &(obj->lightIntensity)) == -1) return -1;
-    if (db_freadInt(stream, &field_74) == -1) return -1;
-    if (db_freadInt(stream, &(obj->sid)) == -1) return -1;
-    if (db_freadInt(stream, &(obj->field_80)) == -1) return -1;
+    if (db_freadRecord(stream, obj, obj_fields, sizeof(obj_fields) / sizeof(obj_fields[0])) == -1) return -1;
 
+    // Outline is saved but never restored.
     obj->outline = 0;
     obj->owner = NULL;
 
@@ -543,8 +717,7 @@ static int obj_load_func(DB_FILE* stream)
                     }
 
                     if (fixMapInventory) {
-                        inventoryItem->item = (Object*)mem_malloc(sizeof(Object));
-                        if (inventoryItem->item == NULL) {
+                        if (obj_create_object(&(inventoryItem->item)) == -1) {
                             debug_printf("Error loading inventory\n");
                             return -1;
                         }
@@ -643,24 +816,7 @@ static void object_fix_weapon_ammo(Object* obj)
 // 0x47B000
 static int obj_write_obj(Object* obj, DB_FILE* stream)
 {
-    if (db_fwriteInt(stream, obj->id) == -1) return -1;
-    if (db_fwriteInt(stream, obj->tile) == -1) return -1;
-    if (db_fwriteInt(stream, obj->x) == -1) return -1;
-    if (db_fwriteInt(stream, obj->y) == -1) return -1;
-    if (db_fwriteInt(stream, obj->sx) == -1) return -1;
-    if (db_fwriteInt(stream, obj->sy) == -1) return -1;
-    if (db_fwriteInt(stream, obj->frame) == -1) return -1;
-    if (db_fwriteInt(stream, obj->rotation) == -1) return -1;
-    if (db_fwriteInt(stream, obj->fid) == -1) return -1;
-    if (db_fwriteInt(stream, obj->flags) == -1) return -1;
-    if (db_fwriteInt(stream, obj->elevation) == -1) return -1;
-    if (db_fwriteInt(stream, obj->pid) == -1) return -1;
-    if (db_fwriteInt(stream, obj->cid) == -1) return -1;
-    if (db_fwriteInt(stream, obj->lightDistance) == -1) return -1;
-    if (db_fwriteInt(stream, obj->lightIntensity) == -1) return -1;
-    if (db_fwriteInt(stream, obj->outline) == -1) return -1;
-    if (db_fwriteInt(stream, obj->sid) == -1) return -1;
-    if (db_fwriteInt(stream, obj->field_80) == -1) return -1;
+    if (db_fwriteRecord(stream, obj, obj_fields, sizeof(obj_fields) / sizeof(obj_fields[0])) == -1) return -1;
     if (proto_write_protoUpdateData(obj, stream) == -1) return -1;
 
     return 0;
@@ -691,7 +847,7 @@ int obj_save(DB_FILE* stream)
         }
 
         for (int tile = 0; tile < HEX_GRID_SIZE; tile++) {
-            for (ObjectListNode* objectListNode = objectTable[tile]; objectListNode != NULL; objectListNode = objectListNode->next) {
+            for (ObjectListNode* objectListNode = objectTable[elevation][tile]; objectListNode != NULL; objectListNode = objectListNode->next) {
                 Object* object = objectListNode->obj;
                 if (object->elevation != elevation) {
                     continue;
@@ -789,7 +945,7 @@ void obj_render_pre_roof(Rect* rect, int elevation)
         if (updateAreaHexHeight > offsetDivTable[offsetIndex] && updateAreaHexWidth > offsetModTable[offsetIndex]) {
             int light;
 
-            ObjectListNode* objectListNode = objectTable[topLeftTile + offsets[offsetIndex]];
+            ObjectListNode* objectListNode = objectTable[elevation][topLeftTile + offsets[offsetIndex]];
             if (objectListNode != NULL) {
                 // NOTE: calls light_get_tile two times, probably result of min/max macro
                 int tileLight = light_get_tile(elevation, objectListNode->obj->tile);
@@ -1080,26 +1236,18 @@ int obj_disconnect(Object* obj, Rect* rect)
         return -1;
     }
 
+    obj_blocking_epoch_bump(obj);
+
     if (obj_adjust_light(obj, 1, rect) == -1) {
         if (rect != NULL) {
             obj_bound(obj, rect);
         }
     }
 
-    if (prev_node != NULL) {
-        prev_node->next = node->next;
-    } else {
-        int tile = node->obj->tile;
-        if (tile == -1) {
-            floatingObjects = floatingObjects->next;
-        } else {
-            objectTable[tile] = objectTable[tile]->next;
-        }
-    }
+    obj_unlink(node, prev_node);
 
-    if (node != NULL) {
-        mem_free(node);
-    }
+    // NOTE: Uninline.
+    obj_destroy_object_node(&node);
 
     obj->tile = -1;
 
@@ -1125,16 +1273,7 @@ int obj_offset(Object* obj, int x, int y, Rect* rect)
             obj_bound(obj_egg, &eggRect);
             rectCopy(rect, &eggRect);
 
-            if (previousNode != NULL) {
-                previousNode->next = node->next;
-            } else {
-                int tile = node->obj->tile;
-                if (tile == -1) {
-                    floatingObjects = floatingObjects->next;
-                } else {
-                    objectTable[tile] = objectTable[tile]->next;
-                }
-            }
+            obj_unlink(node, previousNode);
 
             obj->x += x;
             obj->sx += x;
@@ -1149,16 +1288,7 @@ int obj_offset(Object* obj, int x, int y, Rect* rect)
             obj_offset(obj_egg, x, y, NULL);
             rect_min_bound(rect, &eggRect, rect);
         } else {
-            if (previousNode != NULL) {
-                previousNode->next = node->next;
-            } else {
-                int tile = node->obj->tile;
-                if (tile == -1) {
-                    floatingObjects = floatingObjects->next;
-                } else {
-                    objectTable[tile] = objectTable[tile]->next;
-                }
-            }
+            obj_unlink(node, previousNode);
 
             obj->x += x;
             obj->sx += x;
@@ -1174,16 +1304,7 @@ int obj_offset(Object* obj, int x, int y, Rect* rect)
         if (rect != NULL) {
             obj_bound(obj, rect);
 
-            if (previousNode != NULL) {
-                previousNode->next = node->next;
-            } else {
-                int tile = node->obj->tile;
-                if (tile == -1) {
-                    floatingObjects = floatingObjects->next;
-                } else {
-                    objectTable[tile] = objectTable[tile]->next;
-                }
-            }
+            obj_unlink(node, previousNode);
 
             obj->x += x;
             obj->sx += x;
@@ -1200,16 +1321,7 @@ int obj_offset(Object* obj, int x, int y, Rect* rect)
 
             rect_min_bound(rect, &objectRect, rect);
         } else {
-            if (previousNode != NULL) {
-                previousNode->next = node->next;
-            } else {
-                int tile = node->obj->tile;
-                if (tile == -1) {
-                    floatingObjects = floatingObjects->next;
-                } else {
-                    objectTable[tile] = objectTable[tile]->next;
-                }
-            }
+            obj_unlink(node, previousNode);
 
             obj->x += x;
             obj->sx += x;
@@ -1242,22 +1354,15 @@ int obj_move(Object* a1, int a2, int a3, int elevation, Rect* a5)
             return -1;
         }
 
+        obj_blocking_epoch_bump(a1);
+
         if (obj_adjust_light(a1, 1, a5) == -1) {
             if (a5 != NULL) {
                 obj_bound(a1, a5);
             }
         }
 
-        if (previousNode != NULL) {
-            previousNode->next = node->next;
-        } else {
-            int tile = node->obj->tile;
-            if (tile == -1) {
-                floatingObjects = floatingObjects->next;
-            } else {
-                objectTable[tile] = objectTable[tile]->next;
-            }
-        }
+        obj_unlink(node, previousNode);
 
         a1->tile = -1;
         a1->elevation = elevation;
@@ -1276,16 +1381,7 @@ int obj_move(Object* a1, int a2, int a3, int elevation, Rect* a5)
                 obj_bound(a1, a5);
             }
 
-            if (previousNode != NULL) {
-                previousNode->next = node->next;
-            } else {
-                int tile = node->obj->tile;
-                if (tile != -1) {
-                    objectTable[tile] = objectTable[tile]->next;
-                } else {
-                    floatingObjects = floatingObjects->next;
-                }
-            }
+            obj_unlink(node, previousNode);
 
             a1->elevation = elevation;
             v22 = 1;
@@ -1344,6 +1440,8 @@ int obj_move_to_tile(Object* obj, int tile, int elevation, Rect* rect)
         return -1;
     }
 
+    obj_blocking_epoch_bump(obj);
+
     Rect v23;
     int v5 = obj_adjust_light(obj, 1, rect);
     if (rect != NULL) {
@@ -1355,16 +1453,7 @@ int obj_move_to_tile(Object* obj, int tile, int elevation, Rect* rect)
     }
 
     int oldElevation = obj->elevation;
-    if (prevNode != NULL) {
-        prevNode->next = node->next;
-    } else {
-        int tileIndex = node->obj->tile;
-        if (tileIndex == -1) {
-            floatingObjects = floatingObjects->next;
-        } else {
-            objectTable[tileIndex] = objectTable[tileIndex]->next;
-        }
-    }
+    obj_unlink(node, prevNode);
 
     if (obj_connect_to_tile(node, tile, elevation, rect) == -1) {
         return -1;
@@ -1375,7 +1464,7 @@ int obj_move_to_tile(Object* obj, int tile, int elevation, Rect* rect)
     }
 
     if (obj == obj_dude) {
-        ObjectListNode* objectListNode = objectTable[tile];
+        ObjectListNode* objectListNode = objectTable[elevation][tile];
         while (objectListNode != NULL) {
             Object* obj = objectListNode->obj;
             int elev = obj->elevation;
@@ -1664,15 +1753,118 @@ int obj_dec_rotation(Object* obj, Rect* dirtyRect)
 // 0x47C83C
 void obj_rebuild_all_light()
 {
+    obj_lights_clear();
     light_reset_tiles();
 
-    for (int tile = 0; tile < HEX_GRID_SIZE; tile++) {
-        ObjectListNode* objectListNode = objectTable[tile];
-        while (objectListNode != NULL) {
-            obj_adjust_light(objectListNode->obj, 0, NULL);
-            objectListNode = objectListNode->next;
+    for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
+        int tile = obj_next_occupied_tile(0, elevation);
+        while (tile < HEX_GRID_SIZE) {
+            ObjectListNode* objectListNode = objectTable[elevation][tile];
+            while (objectListNode != NULL) {
+                obj_adjust_light(objectListNode->obj, 0, NULL);
+                objectListNode = objectListNode->next;
+            }
+            tile = obj_next_occupied_tile(tile + 1, elevation);
+        }
+    }
+}
+
+// Re-evaluates lights reaching [tile] on [elevation] after objects occluding
+// light there (walls, doors) were changed. Returns -1 if no light was
+// affected, otherwise returns 0 and area to refresh in [rect].
+int obj_light_tile_changed(int tile, int elevation, Rect* rect)
+{
+    bool changed = false;
+
+    for (int index = 0; index < obj_lights_capacity; index++) {
+        ObjectLight* light = &(obj_lights[index]);
+        if (light->obj == NULL || light->elevation != elevation) {
+            continue;
+        }
+
+        if (tile_dist(light->tile, tile) > light->distance) {
+            continue;
+        }
+
+        obj_light_apply(light, light_subtract_from_tile);
+
+        if (rect != NULL) {
+            if (changed) {
+                rect_min_bound(rect, &(light->rect), rect);
+            } else {
+                rectCopy(rect, &(light->rect));
+            }
+        }
+        changed = true;
+
+        // Record is replaced in place, key stays the same.
+        if (obj_light_compute(light->obj, light) == -1) {
+            obj_light_remove(light);
+
+            // Other entry might have been shifted into this slot.
+            index--;
+            continue;
+        }
+
+        obj_light_apply(light, light_add_to_tile);
+
+        if (rect != NULL) {
+            rect_min_bound(rect, &(light->rect), rect);
+        }
+    }
+
+    return changed ? 0 : -1;
+}
+
+// Checks incrementally maintained tile light levels against full rebuild
+// from every light source on the map. Returns `false` and logs first
+// mismatch if they differ. Lights are not re-evaluated when ordinary objects
+// move around them, so mismatch can also mean some occluder changed without
+// [obj_light_tile_changed].
+bool obj_light_validate()
+{
+    int* levels = (int*)mem_malloc(sizeof(*levels) * ELEVATION_COUNT * HEX_GRID_SIZE);
+    if (levels == NULL) {
+        return false;
+    }
+
+    for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
+        for (int tile = 0; tile < HEX_GRID_SIZE; tile++) {
+            levels[elevation * HEX_GRID_SIZE + tile] = light_get_tile_true(elevation, tile);
+        }
+    }
+
+    // Rebuild into tile light levels without touching [obj_lights].
+    light_reset_tiles();
+
+    for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
+        for (int tile = obj_next_occupied_tile(0, elevation); tile < HEX_GRID_SIZE; tile = obj_next_occupied_tile(tile + 1, elevation)) {
+            ObjectListNode* node = objectTable[elevation][tile];
+            while (node != NULL) {
+                ObjectLight light;
+                if (obj_light_compute(node->obj, &light) == 0) {
+                    obj_light_apply(&light, light_add_to_tile);
+                }
+                node = node->next;
+            }
+        }
+    }
+
+    bool valid = true;
+    for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
+        for (int tile = 0; tile < HEX_GRID_SIZE; tile++) {
+            int level = levels[elevation * HEX_GRID_SIZE + tile];
+            if (valid && light_get_tile_true(elevation, tile) != level) {
+                debug_printf("\nError: obj_light_validate: light mismatch at tile %d, elevation %d (%d, expected %d)", tile, elevation, level, light_get_tile_true(elevation, tile));
+                valid = false;
+            }
+            light_set_tile(elevation, tile, level);
         }
     }
+
+    mem_free(levels);
+
+    return valid;
 }
 
 // 0x47C878
@@ -1793,6 +1985,8 @@ int obj_turn_on(Object* obj, Rect* rect)
     obj->flags &= ~OBJECT_HIDDEN;
     obj->outline &= ~OUTLINE_DISABLED;
 
+    obj_blocking_changed(obj);
+
     if (obj_adjust_light(obj, 0, rect) == -1) {
         if (rect != NULL) {
             obj_bound(obj, rect);
@@ -1829,6 +2023,8 @@ int obj_turn_off(Object* object, Rect* rect)
 
     object->flags |= OBJECT_HIDDEN;
 
+    obj_blocking_changed(object);
+
     if ((object->outline & OUTLINE_TYPE_MASK) != 0) {
         object->outline |= OUTLINE_DISABLED;
     }
@@ -1896,16 +2092,7 @@ int obj_toggle_flat(Object* object, Rect* rect)
     if (rect != NULL) {
         obj_bound(object, rect);
 
-        if (previousNode != NULL) {
-            previousNode->next = node->next;
-        } else {
-            int tile_index = node->obj->tile;
-            if (tile_index == -1) {
-                floatingObjects = floatingObjects->next;
-            } else {
-                objectTable[tile_index] = objectTable[tile_index]->next;
-            }
-        }
+        obj_unlink(node, previousNode);
 
         object->flags ^= OBJECT_FLAT;
 
@@ -1913,16 +2100,7 @@ int obj_toggle_flat(Object* object, Rect* rect)
         obj_bound(object, &v1);
         rect_min_bound(rect, &v1, rect);
     } else {
-        if (previousNode != NULL) {
-            previousNode->next = node->next;
-        } else {
-            int tile = node->obj->tile;
-            if (tile == -1) {
-                floatingObjects = floatingObjects->next;
-            } else {
-                objectTable[tile] = objectTable[tile]->next;
-            }
-        }
+        obj_unlink(node, previousNode);
 
         object->flags ^= OBJECT_FLAT;
 
@@ -2027,19 +2205,22 @@ void obj_remove_all()
     ObjectListNode* node;
     ObjectListNode* prev;
     ObjectListNode* next;
+    unsigned int start = get_time();
 
     scr_remove_all();
 
     for (int tile = 0; tile < HEX_GRID_SIZE; tile++) {
-        node = objectTable[tile];
-        prev = NULL;
-
-        while (node != NULL) {
-            next = node->next;
-            if (obj_remove(node, prev) == -1) {
-                prev = node;
+        for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
+            node = objectTable[elevation][tile];
+            prev = NULL;
+
+            while (node != NULL) {
+                next = node->next;
+                if (obj_remove(node, prev) == -1) {
+                    prev = node;
+                }
+                node = next;
             }
-            node = next;
         }
     }
 
@@ -2058,6 +2239,8 @@ void obj_remove_all()
     obj_last_elev = -1;
     obj_last_is_empty = true;
     obj_last_roof_x = -1;
+
+    obj_remove_all_time = elapsed_tocks(get_time(), start);
 }
 
 // 0x47CF08
@@ -2066,24 +2249,19 @@ Object* obj_find_first()
     find_elev = 0;
 
     ObjectListNode* objectListNode;
-    for (find_tile = 0; find_tile < HEX_GRID_SIZE; find_tile++) {
-        objectListNode = objectTable[find_tile];
-        if (objectListNode) {
-            break;
-        }
-    }
-
+    find_tile = obj_next_occupied_tile(0, -1);
     if (find_tile == HEX_GRID_SIZE) {
         find_ptr = NULL;
         return NULL;
     }
 
+    objectListNode = obj_tile_first_node(find_tile);
     while (objectListNode != NULL) {
         if (art_get_disable(FID_TYPE(objectListNode->obj->fid)) == 0) {
             find_ptr = objectListNode;
             return objectListNode->obj;
         }
-        objectListNode = objectListNode->next;
+        objectListNode = obj_tile_next_node(objectListNode);
     }
 
     find_ptr = NULL;
@@ -2097,11 +2275,16 @@ Object* obj_find_next()
         return NULL;
     }
 
-    ObjectListNode* objectListNode = find_ptr->next;
+    ObjectListNode* objectListNode = obj_tile_next_node(find_ptr);
 
     while (find_tile < HEX_GRID_SIZE) {
         if (objectListNode == NULL) {
-            objectListNode = objectTable[find_tile++];
+            find_tile = obj_next_occupied_tile(find_tile, -1);
+            if (find_tile == HEX_GRID_SIZE) {
+                break;
+            }
+
+            objectListNode = obj_tile_first_node(find_tile++);
         }
 
         while (objectListNode != NULL) {
@@ -2110,7 +2293,7 @@ Object* obj_find_next()
                 find_ptr = objectListNode;
                 return object;
             }
-            objectListNode = objectListNode->next;
+            objectListNode = obj_tile_next_node(objectListNode);
         }
     }
 
@@ -2124,15 +2307,18 @@ Object* obj_find_first_at(int elevation)
     find_elev = elevation;
     find_tile = 0;
 
-    for (find_tile = 0; find_tile < HEX_GRID_SIZE; find_tile++) {
-        ObjectListNode* objectListNode = objectTable[find_tile];
+    if (!elevationIsValid(elevation)) {
+        find_ptr = NULL;
+        return NULL;
+    }
+
+    for (find_tile = obj_next_occupied_tile(0, elevation); find_tile < HEX_GRID_SIZE; find_tile = obj_next_occupied_tile(find_tile + 1, elevation)) {
+        ObjectListNode* objectListNode = objectTable[elevation][find_tile];
         while (objectListNode != NULL) {
             Object* object = objectListNode->obj;
-            if (object->elevation == elevation) {
-                if (!art_get_disable(FID_TYPE(object->fid))) {
-                    find_ptr = objectListNode;
-                    return object;
-                }
+            if (!art_get_disable(FID_TYPE(object->fid))) {
+                find_ptr = objectListNode;
+                return object;
             }
             objectListNode = objectListNode->next;
         }
@@ -2153,16 +2339,19 @@ Object* obj_find_next_at()
 
     while (find_tile < HEX_GRID_SIZE) {
         if (objectListNode == NULL) {
-            objectListNode = objectTable[find_tile++];
+            find_tile = obj_next_occupied_tile(find_tile, find_elev);
+            if (find_tile == HEX_GRID_SIZE) {
+                break;
+            }
+
+            objectListNode = objectTable[find_elev][find_tile++];
         }
 
         while (objectListNode != NULL) {
             Object* object = objectListNode->obj;
-            if (object->elevation == find_elev) {
-                if (!art_get_disable(FID_TYPE(object->fid))) {
-                    find_ptr = objectListNode;
-                    return object;
-                }
+            if (!art_get_disable(FID_TYPE(object->fid))) {
+                find_ptr = objectListNode;
+                return object;
             }
             objectListNode = objectListNode->next;
         }
@@ -2245,7 +2434,15 @@ void obj_bound(Object* obj, Rect* rect)
 // 0x47D2A0
 bool obj_occupied(int tile, int elevation)
 {
-    ObjectListNode* objectListNode = objectTable[tile];
+    if (!elevationIsValid(elevation)) {
+        return false;
+    }
+
+    if (!obj_tile_occupied(tile, elevation)) {
+        return false;
+    }
+
+    ObjectListNode* objectListNode = objectTable[elevation][tile];
     while (objectListNode != NULL) {
         if (objectListNode->obj->elevation == elevation
             && objectListNode->obj != obj_mouse
@@ -2258,6 +2455,125 @@ bool obj_occupied(int tile, int elevation)
     return false;
 }
 
+// Returns blocking epoch of given elevation.
+unsigned int obj_blocking_epoch(int elevation)
+{
+    if (!elevationIsValid(elevation)) {
+        return 0;
+    }
+
+    return obj_blocking_epochs[elevation];
+}
+
+// Notifies that blocking flags of [obj] (`OBJECT_HIDDEN`, `OBJECT_NO_BLOCK`,
+// `OBJECT_SHOOT_THRU`, `OBJECT_LIGHT_THRU`, `OBJECT_MULTIHEX`) were changed
+// while it's on the map.
+void obj_blocking_changed(Object* obj)
+{
+    if (obj == NULL || obj->tile == -1) {
+        return;
+    }
+
+    obj_blocking_epoch_bump(obj);
+
+    ObjectListNode* node;
+    ObjectListNode* previousNode;
+    if (obj_node_ptr(obj, &node, &previousNode) != 0) {
+        return;
+    }
+
+    int mask = obj_blocking_mask(obj);
+    if (mask != node->blocking) {
+        obj_blocking_adjust(obj, node->blocking, -1);
+        node->blocking = mask;
+        obj_blocking_adjust(obj, node->blocking, 1);
+    }
+}
+
+// Returns `true` if there might be an object at [tile] blocking movement,
+// sight, or projectiles (depending on [blocking]), `false` if there is
+// definitely none.
+bool obj_blocking_possible(ObjectBlocking blocking, int tile, int elevation)
+{
+    if (!hexGridTileIsValid(tile)) {
+        return false;
+    }
+
+    if (!elevationIsValid(elevation)) {
+        return false;
+    }
+
+    return (obj_blocking_bits[blocking][elevation][tile / 32] & (1U << (tile % 32))) != 0;
+}
+
+// Checks incrementally maintained blocking counters against actual objects
+// on the map. Returns `false` and logs first mismatch if they differ, which
+// means some code changed blocking flags without calling
+// [obj_blocking_changed].
+bool obj_blocking_validate()
+{
+    unsigned short* counts = (unsigned short*)mem_malloc(sizeof(obj_blocking_counts));
+    if (counts == NULL) {
+        return false;
+    }
+
+    unsigned short* footprint = (unsigned short*)mem_malloc(sizeof(obj_multihex_footprint));
+    if (footprint == NULL) {
+        mem_free(counts);
+        return false;
+    }
+
+    unsigned int* bits = (unsigned int*)mem_malloc(sizeof(obj_blocking_bits));
+    if (bits == NULL) {
+        mem_free(footprint);
+        mem_free(counts);
+        return false;
+    }
+
+    memcpy(counts, obj_blocking_counts, sizeof(obj_blocking_counts));
+    memcpy(footprint, obj_multihex_footprint, sizeof(obj_multihex_footprint));
+    memcpy(bits, obj_blocking_bits, sizeof(obj_blocking_bits));
+
+    // Subtract actual contribution of every object, everything should end up
+    // with zero.
+    for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
+        for (int tile = obj_next_occupied_tile(0, elevation); tile < HEX_GRID_SIZE; tile = obj_next_occupied_tile(tile + 1, elevation)) {
+            ObjectListNode* node = objectTable[elevation][tile];
+            while (node != NULL) {
+                obj_blocking_adjust(node->obj, obj_blocking_mask(node->obj), -1);
+                node = node->next;
+            }
+        }
+    }
+
+    bool valid = true;
+    for (int elevation = 0; elevation < ELEVATION_COUNT && valid; elevation++) {
+        for (int tile = 0; tile < HEX_GRID_SIZE && valid; tile++) {
+            if (obj_multihex_footprint[elevation][tile] != 0) {
+                debug_printf("\nError: obj_blocking_validate: multihex mismatch at tile %d, elevation %d", tile, elevation);
+                valid = false;
+            }
+
+            for (int blocking = 0; blocking < OBJECT_BLOCKING_COUNT && valid; blocking++) {
+                if (obj_blocking_counts[blocking][elevation][tile] != 0) {
+                    debug_printf("\nError: obj_blocking_validate: blocking %d mismatch at tile %d, elevation %d", blocking, tile, elevation);
+                    valid = false;
+                }
+            }
+        }
+    }
+
+    memcpy(obj_blocking_counts, counts, sizeof(obj_blocking_counts));
+    memcpy(obj_multihex_footprint, footprint, sizeof(obj_multihex_footprint));
+    memcpy(obj_blocking_bits, bits, sizeof(obj_blocking_bits));
+
+    mem_free(bits);
+    mem_free(footprint);
+    mem_free(counts);
+
+    return valid;
+}
+
 // 0x47D2F0
 Object* obj_blocking_at(Object* a1, int tile, int elev)
 {
@@ -2269,7 +2585,17 @@ Object* obj_blocking_at(Object* a1, int tile, int elev)
         return NULL;
     }
 
-    objectListNode = objectTable[tile];
+    if (!elevationIsValid(elev)) {
+        return NULL;
+    }
+
+    // Common case - nothing blocking on the tile and no blocking multihex
+    // objects around.
+    if ((obj_blocking_bits[OBJECT_BLOCKING_MOVE][elev][tile / 32] & (1U << (tile % 32))) == 0) {
+        return NULL;
+    }
+
+    objectListNode = objectTable[elev][tile];
     while (objectListNode != NULL) {
         v7 = objectListNode->obj;
         if (v7->elevation == elev) {
@@ -2285,10 +2611,14 @@ Object* obj_blocking_at(Object* a1, int tile, int elev)
         objectListNode = objectListNode->next;
     }
 
+    if (obj_multihex_footprint[elev][tile] == 0) {
+        return NULL;
+    }
+
     for (int rotation = 0; rotation < ROTATION_COUNT; rotation++) {
         int neighboor = tile_num_in_direction(tile, rotation, 1);
         if (hexGridTileIsValid(neighboor)) {
-            objectListNode = objectTable[neighboor];
+            objectListNode = objectTable[elev][neighboor];
             while (objectListNode != NULL) {
                 v7 = objectListNode->obj;
                 if ((v7->flags & OBJECT_MULTIHEX) != 0) {
@@ -2319,7 +2649,11 @@ int obj_scroll_blocking_at(int tile, int elev)
         return -1;
     }
 
-    ObjectListNode* objectListNode = objectTable[tile];
+    if (!elevationIsValid(elev)) {
+        return -1;
+    }
+
+    ObjectListNode* objectListNode = objectTable[elev][tile];
     while (objectListNode != NULL) {
         if (elev < objectListNode->obj->elevation) {
             break;
@@ -2338,7 +2672,19 @@ int obj_scroll_blocking_at(int tile, int elev)
 // 0x47D41C
 Object* obj_sight_blocking_at(Object* a1, int tile, int elevation)
 {
-    ObjectListNode* objectListNode = objectTable[tile];
+    if (!hexGridTileIsValid(tile)) {
+        return NULL;
+    }
+
+    if (!elevationIsValid(elevation)) {
+        return NULL;
+    }
+
+    if ((obj_blocking_bits[OBJECT_BLOCKING_SIGHT][elevation][tile / 32] & (1U << (tile % 32))) == 0) {
+        return NULL;
+    }
+
+    ObjectListNode* objectListNode = objectTable[elevation][tile];
     while (objectListNode != NULL) {
         Object* object = objectListNode->obj;
         if (object->elevation == elevation
@@ -2383,10 +2729,14 @@ int obj_create_list(int tile, int elevation, int objectType, Object*** objectLis
         return -1;
     }
 
+    if (!elevationIsValid(elevation)) {
+        return 0;
+    }
+
     int count = 0;
     if (tile == -1) {
-        for (int index = 0; index < HEX_GRID_SIZE; index++) {
-            ObjectListNode* objectListNode = objectTable[index];
+        for (int index = obj_next_occupied_tile(0, elevation); index < HEX_GRID_SIZE; index = obj_next_occupied_tile(index + 1, elevation)) {
+            ObjectListNode* objectListNode = objectTable[elevation][index];
             while (objectListNode != NULL) {
                 Object* obj = objectListNode->obj;
                 if ((obj->flags & OBJECT_HIDDEN) == 0
@@ -2398,7 +2748,7 @@ int obj_create_list(int tile, int elevation, int objectType, Object*** objectLis
             }
         }
     } else {
-        ObjectListNode* objectListNode = objectTable[tile];
+        ObjectListNode* objectListNode = objectTable[elevation][tile];
         while (objectListNode != NULL) {
             Object* obj = objectListNode->obj;
             if ((obj->flags & OBJECT_HIDDEN) == 0
@@ -2414,14 +2764,14 @@ int obj_create_list(int tile, int elevation, int objectType, Object*** objectLis
         return 0;
     }
 
-    Object** objects = *objectListPtr = (Object**)mem_malloc(sizeof(*objects) * count);
+    Object** objects = *objectListPtr = (Object**)obj_scratch_alloc(sizeof(*objects) * count);
     if (objects == NULL) {
         return -1;
     }
 
     if (tile == -1) {
-        for (int index = 0; index < HEX_GRID_SIZE; index++) {
-            ObjectListNode* objectListNode = objectTable[index];
+        for (int index = obj_next_occupied_tile(0, elevation); index < HEX_GRID_SIZE; index = obj_next_occupied_tile(index + 1, elevation)) {
+            ObjectListNode* objectListNode = objectTable[elevation][index];
             while (objectListNode) {
                 Object* obj = objectListNode->obj;
                 if ((obj->flags & OBJECT_HIDDEN) == 0
@@ -2433,7 +2783,7 @@ int obj_create_list(int tile, int elevation, int objectType, Object*** objectLis
             }
         }
     } else {
-        ObjectListNode* objectListNode = objectTable[tile];
+        ObjectListNode* objectListNode = objectTable[elevation][tile];
         while (objectListNode != NULL) {
             Object* obj = objectListNode->obj;
             if ((obj->flags & OBJECT_HIDDEN) == 0
@@ -2452,7 +2802,7 @@ int obj_create_list(int tile, int elevation, int objectType, Object*** objectLis
 void obj_delete_list(Object** objectList)
 {
     if (objectList != NULL) {
-        mem_free(objectList);
+        obj_scratch_free(objectList);
     }
 }
 
@@ -2574,6 +2924,90 @@ void intensity_mask_buf_to_buf(unsigned char* src, int srcWidth, int srcHeight,
     }
 }
 
+// Same as [trans_buf_to_buf], but only visits opaque pixels listed in [rows].
+// [src] is entire frame of [srcPitch]x[frameHeight] pixels, [srcX], [srcY],
+// [srcWidth] and [srcHeight] specify the part of it to copy.
+void trans_spans_to_buf(unsigned char* src, int srcPitch, int frameHeight, int* rows, int srcX, int srcY, int srcWidth, int srcHeight, unsigned char* dest, int destX, int destY, int destPitch)
+{
+    ArtSpan* spans = (ArtSpan*)(rows + frameHeight + 1);
+    int srcRight = srcX + srcWidth;
+
+    src += srcPitch * srcY;
+    dest += destPitch * destY + destX - srcX;
+
+    for (int y = srcY; y < srcY + srcHeight; y++) {
+        ArtSpan* end = spans + rows[y + 1];
+        for (ArtSpan* span = spans + rows[y]; span < end; span++) {
+            int from = span->x > srcX ? span->x : srcX;
+            int to = span->x + span->length < srcRight ? span->x + span->length : srcRight;
+            if (from < to) {
+                memcpy(dest + from, src + from, to - from);
+            }
+        }
+
+        src += srcPitch;
+        dest += destPitch;
+    }
+}
+
+// Same as [dark_trans_buf_to_buf], but only visits opaque pixels listed in
+// [rows] (see [trans_spans_to_buf]).
+void dark_trans_spans_to_buf(unsigned char* src, int srcPitch, int frameHeight, int* rows, int srcX, int srcY, int srcWidth, int srcHeight, unsigned char* dest, int destX, int destY, int destPitch, int light)
+{
+    ArtSpan* spans = (ArtSpan*)(rows + frameHeight + 1);
+    int srcRight = srcX + srcWidth;
+    int lightModifier = light >> 9;
+
+    src += srcPitch * srcY;
+    dest += destPitch * destY + destX - srcX;
+
+    for (int y = srcY; y < srcY + srcHeight; y++) {
+        ArtSpan* end = spans + rows[y + 1];
+        for (ArtSpan* span = spans + rows[y]; span < end; span++) {
+            int from = span->x > srcX ? span->x : srcX;
+            int to = span->x + span->length < srcRight ? span->x + span->length : srcRight;
+            for (int x = from; x < to; x++) {
+                unsigned char b = src[x];
+                if (b < 0xE5) {
+                    b = intensityColorTable[b][lightModifier];
+                }
+                dest[x] = b;
+            }
+        }
+
+        src += srcPitch;
+        dest += destPitch;
+    }
+}
+
+// Same as [dark_translucent_trans_buf_to_buf], but only visits opaque pixels
+// listed in [rows] (see [trans_spans_to_buf]).
+void dark_translucent_trans_spans_to_buf(unsigned char* src, int srcPitch, int frameHeight, int* rows, int srcX, int srcY, int srcWidth, int srcHeight, unsigned char* dest, int destX, int destY, int destPitch, int light, unsigned char* a10, unsigned char* a11)
+{
+    ArtSpan* spans = (ArtSpan*)(rows + frameHeight + 1);
+    int srcRight = srcX + srcWidth;
+    int lightModifier = light >> 9;
+
+    src += srcPitch * srcY;
+    dest += destPitch * destY + destX - srcX;
+
+    for (int y = srcY; y < srcY + srcHeight; y++) {
+        ArtSpan* end = spans + rows[y + 1];
+        for (ArtSpan* span = spans + rows[y]; span < end; span++) {
+            int from = span->x > srcX ? span->x : srcX;
+            int to = span->x + span->length < srcRight ? span->x + span->length : srcRight;
+            for (int x = from; x < to; x++) {
+                unsigned int index = a11[src[x]] << 8;
+                index = a10[index + dest[x]];
+                dest[x] = intensityColorTable[index][lightModifier];
+            }
+        }
+
+        src += srcPitch;
+        dest += destPitch;
+    }
+}
+
 // 0x47D9A4
 int obj_outline_object(Object* obj, int outlineType, Rect* rect)
 {
@@ -2627,8 +3061,14 @@ int obj_intersects_with(Object* object, int x, int y)
         CacheEntry* handle;
         Art* art = art_ptr_lock(object->fid, &handle);
         if (art != NULL) {
-            int width = art_frame_width(art, object->frame, object->rotation);
-            int height = art_frame_length(art, object->frame, object->rotation);
+            int width;
+            int height;
+            unsigned char* data;
+            if (art_frame_info(art, object->frame, object->rotation, &width, &height, &data, NULL, NULL) == -1) {
+                width = -1;
+                height = -1;
+                data = NULL;
+            }
 
             int minX;
             int minY;
@@ -2660,7 +3100,6 @@ int obj_intersects_with(Object* object, int x, int y)
             }
 
             if (x >= minX && x <= maxX && y >= minY && y <= maxY) {
-                unsigned char* data = art_frame_data(art, object->frame, object->rotation);
                 if (data != NULL) {
                     if (data[width * (y - minY) + x - minX] != 0) {
                         flags |= 0x01;
@@ -2719,12 +3158,13 @@ int obj_create_intersect_list(int x, int y, int elevation, int objectType, Objec
     }
 
     int count = 0;
+    int capacity = 0;
 
     int parity = tile_center_tile & 1;
     for (int index = 0; index < updateHexArea; index++) {
         int v7 = orderTable[parity][index];
         if (offsetDivTable[v7] < 30 && offsetModTable[v7] < 20) {
-            ObjectListNode* objectListNode = objectTable[offsetTable[parity][v7] + v5];
+            ObjectListNode* objectListNode = objectTable[elevation][offsetTable[parity][v7] + v5];
             while (objectListNode != NULL) {
                 Object* object = objectListNode->obj;
                 if (object->elevation > elevation) {
@@ -2736,11 +3176,22 @@ int obj_create_intersect_list(int x, int y, int elevation, int objectType, Objec
                     && object != obj_egg) {
                     int flags = obj_intersects_with(object, x, y);
                     if (flags != 0) {
-                        ObjectWithFlags* entries = (ObjectWithFlags*)mem_realloc(*entriesPtr, sizeof(*entries) * (count + 1));
-                        if (entries != NULL) {
-                            *entriesPtr = entries;
-                            entries[count].object = object;
-                            entries[count].flags = flags;
+                        if (count == capacity) {
+                            int newCapacity = capacity != 0 ? capacity * 2 : 16;
+                            ObjectWithFlags* entries = (ObjectWithFlags*)obj_scratch_alloc(sizeof(*entries) * newCapacity);
+                            if (entries != NULL) {
+                                if (*entriesPtr != NULL) {
+                                    memcpy(entries, *entriesPtr, sizeof(*entries) * count);
+                                    obj_scratch_free(*entriesPtr);
+                                }
+                                *entriesPtr = entries;
+                                capacity = newCapacity;
+                            }
+                        }
+
+                        if (count < capacity) {
+                            (*entriesPtr)[count].object = object;
+                            (*entriesPtr)[count].flags = flags;
                             count++;
                         }
                     }
@@ -2758,7 +3209,7 @@ int obj_create_intersect_list(int x, int y, int elevation, int objectType, Objec
 void obj_delete_intersect_list(ObjectWithFlags** entriesPtr)
 {
     if (entriesPtr != NULL && *entriesPtr != NULL) {
-        mem_free(*entriesPtr);
+        obj_scratch_free(*entriesPtr);
         *entriesPtr = NULL;
     }
 }
@@ -2813,7 +3264,7 @@ void obj_process_seen()
             for (v5 = v7; v5 < v7 + 8; v5++) {
                 if (v8 & obj_seen_check[i]) {
                     if (v5 < 40000) {
-                        for (obj_entry = objectTable[v5]; obj_entry != NULL; obj_entry = obj_entry->next) {
+                        for (obj_entry = objectTable[obj_dude->elevation][v5]; obj_entry != NULL; obj_entry = obj_entry->next) {
                             if (obj_entry->obj->elevation == obj_dude->elevation) {
                                 obj_entry->obj->flags |= OBJECT_SEEN;
                             }
@@ -2941,10 +3392,21 @@ void obj_preload_art_cache(int flags)
 // 0x47E250
 static int obj_object_table_init()
 {
+    int elevation;
     int tile;
 
-    for (tile = 0; tile < HEX_GRID_SIZE; tile++) {
-        objectTable[tile] = NULL;
+    for (elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
+        for (tile = 0; tile < HEX_GRID_SIZE; tile++) {
+            objectTable[elevation][tile] = NULL;
+            obj_multihex_footprint[elevation][tile] = 0;
+        }
+
+        memset(objectTableOccupied[elevation], 0, sizeof(objectTableOccupied[elevation]));
+
+        for (int blocking = 0; blocking < OBJECT_BLOCKING_COUNT; blocking++) {
+            memset(obj_blocking_counts[blocking][elevation], 0, sizeof(obj_blocking_counts[blocking][elevation]));
+            memset(obj_blocking_bits[blocking][elevation], 0, sizeof(obj_blocking_bits[blocking][elevation]));
+        }
     }
 
     return 0;
@@ -3434,7 +3896,7 @@ static int obj_create_object(Object** objectPtr)
         return -1;
     }
 
-    Object* object = *objectPtr = (Object*)mem_malloc(sizeof(Object));
+    Object* object = *objectPtr = (Object*)obj_pool_alloc(&obj_object_pool);
     if (object == NULL) {
         return -1;
     }
@@ -3464,7 +3926,14 @@ static void obj_destroy_object(Object** objectPtr)
         return;
     }
 
-    mem_free(*objectPtr);
+    // Objects removed with the whole map are destroyed without turning their
+    // lights off, tile light levels are reset anyway.
+    ObjectLight* light = obj_light_find(*objectPtr);
+    if (light != NULL) {
+        obj_light_remove(light);
+    }
+
+    obj_pool_free(&obj_object_pool, *objectPtr);
 
     *objectPtr = NULL;
 }
@@ -3476,13 +3945,14 @@ static int obj_create_object_node(ObjectListNode** nodePtr)
         return -1;
     }
 
-    ObjectListNode* node = *nodePtr = (ObjectListNode*)mem_malloc(sizeof(*node));
+    ObjectListNode* node = *nodePtr = (ObjectListNode*)obj_pool_alloc(&obj_node_pool);
     if (node == NULL) {
         return -1;
     }
 
     node->obj = NULL;
     node->next = NULL;
+    node->blocking = 0;
 
     return 0;
 }
@@ -3498,7 +3968,7 @@ static void obj_destroy_object_node(ObjectListNode** nodePtr)
         return;
     }
 
-    mem_free(*nodePtr);
+    obj_pool_free(&obj_node_pool, *nodePtr);
 
     *nodePtr = NULL;
 }
@@ -3516,7 +3986,7 @@ static int obj_node_ptr(Object* object, ObjectListNode** nodePtr, ObjectListNode
 
     int tile = object->tile;
     if (tile != -1) {
-        *nodePtr = objectTable[tile];
+        *nodePtr = objectTable[object->elevation][tile];
     } else {
         *nodePtr = floatingObjects;
     }
@@ -3564,7 +4034,7 @@ static void obj_insert(ObjectListNode* objectListNode)
         Art* art = NULL;
         CacheEntry* cacheHandle = NULL;
 
-        objectListNodePtr = &(objectTable[objectListNode->obj->tile]);
+        objectListNodePtr = &(objectTable[objectListNode->obj->elevation][objectListNode->obj->tile]);
 
         while (*objectListNodePtr != NULL) {
             Object* obj = (*objectListNodePtr)->obj;
@@ -3608,6 +4078,234 @@ static void obj_insert(ObjectListNode* objectListNode)
 
     objectListNode->next = *objectListNodePtr;
     *objectListNodePtr = objectListNode;
+
+    Object* obj = objectListNode->obj;
+    if (obj->tile != -1) {
+        objectTableOccupied[obj->elevation][obj->tile / 32] |= 1U << (obj->tile % 32);
+
+        objectListNode->blocking = obj_blocking_mask(obj);
+        obj_blocking_adjust(obj, objectListNode->blocking, 1);
+    }
+}
+
+// Removes [node] from the list it's currently linked to. [previousNode] is
+// the node preceding it in that list or `NULL` if [node] is list head.
+static void obj_unlink(ObjectListNode* node, ObjectListNode* previousNode)
+{
+    Object* obj = node->obj;
+    if (previousNode != NULL) {
+        previousNode->next = node->next;
+    } else {
+        if (obj->tile == -1) {
+            floatingObjects = floatingObjects->next;
+        } else {
+            objectTable[obj->elevation][obj->tile] = objectTable[obj->elevation][obj->tile]->next;
+        }
+    }
+
+    if (obj->tile != -1) {
+        if (objectTable[obj->elevation][obj->tile] == NULL) {
+            objectTableOccupied[obj->elevation][obj->tile / 32] &= ~(1U << (obj->tile % 32));
+        }
+
+        obj_blocking_adjust(obj, node->blocking, -1);
+        node->blocking = 0;
+    }
+}
+
+// Returns blocking contribution of [obj] as a set of `1 << ObjectBlocking`
+// bits, plus [OBJECT_BLOCKING_MULTIHEX] for multihex objects.
+//
+// NOTE: Mirrors object filters in [obj_blocking_at],
+// [obj_sight_blocking_at], and projectile checks in
+// [make_straight_path_func].
+static int obj_blocking_mask(Object* obj)
+{
+    int mask = 0;
+
+    if ((obj->flags & OBJECT_MULTIHEX) != 0) {
+        mask |= OBJECT_BLOCKING_MULTIHEX;
+    }
+
+    if ((obj->flags & OBJECT_HIDDEN) != 0) {
+        return mask;
+    }
+
+    int type = FID_TYPE(obj->fid);
+    if (type == OBJ_TYPE_CRITTER || type == OBJ_TYPE_SCENERY || type == OBJ_TYPE_WALL) {
+        if ((obj->flags & OBJECT_NO_BLOCK) == 0) {
+            mask |= 1 << OBJECT_BLOCKING_MOVE;
+
+            if ((obj->flags & OBJECT_SHOOT_THRU) == 0) {
+                mask |= 1 << OBJECT_BLOCKING_SHOOT;
+            }
+        }
+    }
+
+    if (type == OBJ_TYPE_SCENERY || type == OBJ_TYPE_WALL) {
+        if ((obj->flags & OBJECT_LIGHT_THRU) == 0) {
+            mask |= 1 << OBJECT_BLOCKING_SIGHT;
+        }
+    }
+
+    return mask;
+}
+
+// Adjusts blocking counters (and multihex footprint) around [obj] by [delta]
+// according to blocking [mask].
+//
+// NOTE: Multihex objects mark entire 3x3 block around object's tile which is
+// a superset of its hex neighbours regardless of column parity and map edges.
+static void obj_blocking_adjust(Object* obj, int mask, int delta)
+{
+    int elevation = obj->elevation;
+
+    if ((mask & (1 << OBJECT_BLOCKING_SIGHT)) != 0) {
+        obj_blocking_count_adjust(OBJECT_BLOCKING_SIGHT, elevation, obj->tile, delta);
+    }
+
+    if ((mask & OBJECT_BLOCKING_MULTIHEX) == 0) {
+        if ((mask & (1 << OBJECT_BLOCKING_MOVE)) != 0) {
+            obj_blocking_count_adjust(OBJECT_BLOCKING_MOVE, elevation, obj->tile, delta);
+        }
+
+        if ((mask & (1 << OBJECT_BLOCKING_SHOOT)) != 0) {
+            obj_blocking_count_adjust(OBJECT_BLOCKING_SHOOT, elevation, obj->tile, delta);
+        }
+
+        return;
+    }
+
+    int x = obj->tile % HEX_GRID_WIDTH;
+    int y = obj->tile / HEX_GRID_WIDTH;
+
+    for (int dy = -1; dy <= 1; dy++) {
+        if (y + dy < 0 || y + dy >= HEX_GRID_HEIGHT) {
+            continue;
+        }
+
+        for (int dx = -1; dx <= 1; dx++) {
+            if (x + dx < 0 || x + dx >= HEX_GRID_WIDTH) {
+                continue;
+            }
+
+            int tile = (y + dy) * HEX_GRID_WIDTH + x + dx;
+            obj_multihex_footprint[elevation][tile] += delta;
+
+            if ((mask & (1 << OBJECT_BLOCKING_MOVE)) != 0) {
+                obj_blocking_count_adjust(OBJECT_BLOCKING_MOVE, elevation, tile, delta);
+            }
+
+            if ((mask & (1 << OBJECT_BLOCKING_SHOOT)) != 0) {
+                obj_blocking_count_adjust(OBJECT_BLOCKING_SHOOT, elevation, tile, delta);
+            }
+        }
+    }
+}
+
+// Adjusts [blocking] counter at [tile] by [delta] keeping bitset in sync.
+static void obj_blocking_count_adjust(int blocking, int elevation, int tile, int delta)
+{
+    unsigned short* count = &(obj_blocking_counts[blocking][elevation][tile]);
+    *count += delta;
+
+    if (*count != 0) {
+        obj_blocking_bits[blocking][elevation][tile / 32] |= 1U << (tile % 32);
+    } else {
+        obj_blocking_bits[blocking][elevation][tile / 32] &= ~(1U << (tile % 32));
+    }
+}
+
+// Increments blocking epoch of elevation [obj] is on if it's an object
+// which can block movement.
+static void obj_blocking_epoch_bump(Object* obj)
+{
+    if (obj == NULL || obj->tile == -1) {
+        return;
+    }
+
+    if (!elevationIsValid(obj->elevation)) {
+        return;
+    }
+
+    switch (FID_TYPE(obj->fid)) {
+    case OBJ_TYPE_CRITTER:
+    case OBJ_TYPE_SCENERY:
+    case OBJ_TYPE_WALL:
+        obj_blocking_epochs[obj->elevation] += 1;
+        break;
+    }
+}
+
+// Returns `true` if there are objects at [tile] on [elevation].
+static bool obj_tile_occupied(int tile, int elevation)
+{
+    return (objectTableOccupied[elevation][tile / 32] & (1U << (tile % 32))) != 0;
+}
+
+// Returns the first tile starting from [tile] which has objects on
+// [elevation] (or on any elevation if [elevation] is -1), or `HEX_GRID_SIZE`
+// if there is no such tile.
+static int obj_next_occupied_tile(int tile, int elevation)
+{
+    while (tile < HEX_GRID_SIZE) {
+        int index = tile / 32;
+
+        unsigned int bits;
+        if (elevation == -1) {
+            bits = objectTableOccupied[0][index] | objectTableOccupied[1][index] | objectTableOccupied[2][index];
+        } else {
+            bits = objectTableOccupied[elevation][index];
+        }
+
+        bits &= 0xFFFFFFFFU << (tile % 32);
+
+        if (bits != 0) {
+            int bit = 0;
+            while ((bits & (1U << bit)) == 0) {
+                bit++;
+            }
+            return index * 32 + bit;
+        }
+
+        tile = (index + 1) * 32;
+    }
+
+    return HEX_GRID_SIZE;
+}
+
+// Returns the first object at [tile] in the order of elevations.
+static ObjectListNode* obj_tile_first_node(int tile)
+{
+    for (int elevation = 0; elevation < ELEVATION_COUNT; elevation++) {
+        if (objectTable[elevation][tile] != NULL) {
+            return objectTable[elevation][tile];
+        }
+    }
+
+    return NULL;
+}
+
+// Returns object following [node] at the same tile, continuing to upper
+// elevations when [node] is the last one on its elevation.
+static ObjectListNode* obj_tile_next_node(ObjectListNode* node)
+{
+    if (node->next != NULL) {
+        return node->next;
+    }
+
+    Object* obj = node->obj;
+    if (obj->tile == -1) {
+        return NULL;
+    }
+
+    for (int elevation = obj->elevation + 1; elevation < ELEVATION_COUNT; elevation++) {
+        if (objectTable[elevation][obj->tile] != NULL) {
+            return objectTable[elevation][obj->tile];
+        }
+    }
+
+    return NULL;
 }
 
 // 0x47F13C
@@ -3628,17 +4326,10 @@ static int obj_remove(ObjectListNode* a1, ObjectListNode* a2)
         scr_remove(a1->obj->sid);
     }
 
+    obj_blocking_epoch_bump(a1->obj);
+
     if (a1 != a2) {
-        if (a2 != NULL) {
-            a2->next = a1->next;
-        } else {
-            int tile = a1->obj->tile;
-            if (tile == -1) {
-                floatingObjects = floatingObjects->next;
-            } else {
-                objectTable[tile] = objectTable[tile]->next;
-            }
-        }
+        obj_unlink(a1, a2);
     }
 
     // NOTE: Uninline.
@@ -3673,6 +4364,8 @@ static int obj_connect_to_tile(ObjectListNode* node, int tile, int elevation, Re
 
     obj_insert(node);
 
+    obj_blocking_epoch_bump(node->obj);
+
     if (obj_adjust_light(node->obj, 0, rect) == -1) {
         if (rect != NULL) {
             obj_bound(node->obj, rect);
@@ -3689,6 +4382,73 @@ static int obj_adjust_light(Object* obj, int a2, Rect* rect)
         return -1;
     }
 
+    ObjectLight* light = obj_light_find(obj);
+
+    if (a2) {
+        // Remove exactly what was added, even if occluders or flags of [obj]
+        // changed since then.
+        if (light == NULL) {
+            return -1;
+        }
+
+        obj_light_apply(light, light_subtract_from_tile);
+
+        if (rect != NULL) {
+            Rect objectRect;
+            obj_bound(obj, &objectRect);
+            rect_min_bound(&(light->rect), &objectRect, rect);
+        }
+
+        obj_light_remove(light);
+
+        return 0;
+    }
+
+    Rect staleRect;
+    bool stale = false;
+    if (light != NULL) {
+        // Light is added again without being removed, replace it rather than
+        // adding it twice.
+        obj_light_apply(light, light_subtract_from_tile);
+        rectCopy(&staleRect, &(light->rect));
+        obj_light_remove(light);
+        stale = true;
+    }
+
+    ObjectLight newLight;
+    if (obj_light_compute(obj, &newLight) == -1) {
+        if (stale) {
+            if (rect != NULL) {
+                rectCopy(rect, &staleRect);
+            }
+            return 0;
+        }
+        return -1;
+    }
+
+    light = obj_light_insert(&newLight);
+    if (light == NULL) {
+        debug_printf("\nError: obj_adjust_light: out of memory");
+        return -1;
+    }
+
+    obj_light_apply(light, light_add_to_tile);
+
+    if (rect != NULL) {
+        rectCopy(rect, &(light->rect));
+        if (stale) {
+            rect_min_bound(rect, &staleRect, rect);
+        }
+    }
+
+    return 0;
+}
+
+// Computes which hexes [obj] lights with its current position, light
+// settings and occluders around it, without changing light levels. Returns
+// -1 if [obj] does not emit light.
+static int obj_light_compute(Object* obj, ObjectLight* light)
+{
     if (obj->lightIntensity <= 0) {
         return -1;
     }
@@ -3705,11 +4465,12 @@ static int obj_adjust_light(Object* obj, int a2, Rect* rect)
         return -1;
     }
 
-    AdjustLightIntensityProc* adjustLightIntensity = a2 ? light_subtract_from_tile : light_add_to_tile;
-    adjustLightIntensity(obj->elevation, obj->tile, obj->lightIntensity);
+    light->obj = obj;
+    light->tile = obj->tile;
+    light->elevation = obj->elevation;
 
-    Rect objectRect;
-    obj_bound(obj, &objectRect);
+    // NOTE: Own hex gets intensity before it's clamped.
+    light->intensity = obj->lightIntensity;
 
     if (obj->lightDistance > 8) {
         obj->lightDistance = 8;
@@ -3719,45 +4480,14 @@ static int obj_adjust_light(Object* obj, int a2, Rect* rect)
         obj->lightIntensity = 65536;
     }
 
-    int(*v70)[36] = light_offsets[obj->tile & 1];
-    int v7 = (obj->lightIntensity - 655) / (obj->lightDistance + 1);
-    int v28[36];
-    v28[0] = obj->lightIntensity - v7;
-    v28[1] = v28[0] - v7;
-    v28[8] = v28[0] - v7;
-    v28[2] = v28[0] - v7 - v7;
-    v28[9] = v28[2];
-    v28[15] = v28[0] - v7 - v7;
-    v28[3] = v28[2] - v7;
-    v28[10] = v28[2] - v7;
-    v28[16] = v28[2] - v7;
-    v28[21] = v28[2] - v7;
-    v28[4] = v28[2] - v7 - v7;
-    v28[11] = v28[4];
-    v28[17] = v28[2] - v7 - v7;
-    v28[22] = v28[2] - v7 - v7;
-    v28[26] = v28[2] - v7 - v7;
-    v28[5] = v28[4] - v7;
-    v28[12] = v28[4] - v7;
-    v28[18] = v28[4] - v7;
-    v28[23] = v28[4] - v7;
-    v28[27] = v28[4] - v7;
-    v28[30] = v28[4] - v7;
-    v28[6] = v28[4] - v7 - v7;
-    v28[13] = v28[6];
-    v28[19] = v28[4] - v7 - v7;
-    v28[24] = v28[4] - v7 - v7;
-    v28[28] = v28[4] - v7 - v7;
-    v28[31] = v28[4] - v7 - v7;
-    v28[33] = v28[4] - v7 - v7;
-    v28[7] = v28[6] - v7;
-    v28[14] = v28[6] - v7;
-    v28[20] = v28[6] - v7;
-    v28[25] = v28[6] - v7;
-    v28[29] = v28[6] - v7;
-    v28[32] = v28[6] - v7;
-    v28[34] = v28[6] - v7;
-    v28[35] = v28[6] - v7;
+    light->distance = obj->lightDistance;
+    light->falloffIntensity = obj->lightIntensity;
+    light->falloffStep = (obj->lightIntensity - 655) / (obj->lightDistance + 1);
+    memset(light->lit, 0, sizeof(light->lit));
+
+    obj_bound(obj, &(light->rect));
+
+    int(*offsets)[36] = light_offsets[obj->tile & 1];
 
     for (int index = 0; index < 36; index++) {
         if (obj->lightDistance >= light_distance[index]) {
@@ -4254,11 +4984,11 @@ static int obj_adjust_light(Object* obj, int a2, Rect* rect)
 
                 if (v14 == 0) {
                     // TODO: Check.
-                    int tile = obj->tile + v70[rotation][index];
+                    int tile = obj->tile + offsets[rotation][index];
                     if (hexGridTileIsValid(tile)) {
                         bool v12 = true;
 
-                        ObjectListNode* objectListNode = objectTable[tile];
+                        ObjectListNode* objectListNode = objectTable[obj->elevation][tile];
                         while (objectListNode != NULL) {
                             if ((objectListNode->obj->flags & OBJECT_HIDDEN) == 0) {
                                 if (objectListNode->obj->elevation > obj->elevation) {
@@ -4268,7 +4998,7 @@ static int obj_adjust_light(Object* obj, int a2, Rect* rect)
                                 if (objectListNode->obj->elevation == obj->elevation) {
                                     Rect v29;
                                     obj_bound(objectListNode->obj, &v29);
-                                    rect_min_bound(&objectRect, &v29, &objectRect);
+                                    rect_min_bound(&(light->rect), &v29, &(light->rect));
 
                                     v14 = (objectListNode->obj->flags & OBJECT_LIGHT_THRU) == 0;
 
@@ -4318,7 +5048,8 @@ static int obj_adjust_light(Object* obj, int a2, Rect* rect)
                         }
 
                         if (v12) {
-                            adjustLightIntensity(obj->elevation, tile, v28[index]);
+                            int bit = rotation * 36 + index;
+                            light->lit[bit / 32] |= 1U << (bit % 32);
                         }
                     }
                 }
@@ -4328,26 +5059,419 @@ static int obj_adjust_light(Object* obj, int a2, Rect* rect)
         }
     }
 
-    if (rect != NULL) {
-        Rect* lightDistanceRect = &(light_rect[obj->lightDistance]);
-        memcpy(rect, lightDistanceRect, sizeof(*lightDistanceRect));
+    Rect lightRect;
+    rectCopy(&lightRect, &(light_rect[obj->lightDistance]));
 
-        int x;
-        int y;
-        tile_coord(obj->tile, &x, &y, obj->elevation);
-        x += 16;
-        y += 8;
+    int x;
+    int y;
+    tile_coord(obj->tile, &x, &y, obj->elevation);
+    x += 16;
+    y += 8;
+
+    x -= lightRect.lrx / 2;
+    y -= lightRect.lry / 2;
+
+    rectOffset(&lightRect, x, y);
+    rect_min_bound(&lightRect, &(light->rect), &(light->rect));
+
+    return 0;
+}
+
+// Adds or subtracts (depending on [adjustLightIntensity]) light levels
+// recorded in [light].
+static void obj_light_apply(ObjectLight* light, AdjustLightIntensityProc* adjustLightIntensity)
+{
+    adjustLightIntensity(light->elevation, light->tile, light->intensity);
+
+    int(*offsets)[36] = light_offsets[light->tile & 1];
+    for (int bit = 0; bit < OBJECT_LIGHT_OFFSETS; bit++) {
+        if ((light->lit[bit / 32] & (1U << (bit % 32))) != 0) {
+            int rotation = bit / 36;
+            int index = bit % 36;
+            int intensity = light->falloffIntensity - light->falloffStep * light_distance[index];
+            adjustLightIntensity(light->elevation, light->tile + offsets[rotation][index], intensity);
+        }
+    }
+}
+
+static unsigned int obj_light_hash(Object* obj)
+{
+    unsigned int hash = (unsigned int)(uintptr_t)obj;
+    hash ^= hash >> 16;
+    hash *= 0x45D9F3B;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+// Returns light record of [obj], or `NULL` if its light is not added to tile
+// light levels.
+static ObjectLight* obj_light_find(Object* obj)
+{
+    if (obj_lights_length == 0) {
+        return NULL;
+    }
+
+    unsigned int mask = obj_lights_capacity - 1;
+    unsigned int pos = obj_light_hash(obj) & mask;
+    while (obj_lights[pos].obj != NULL) {
+        if (obj_lights[pos].obj == obj) {
+            return &(obj_lights[pos]);
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    return NULL;
+}
+
+// Stores copy of [light] which must not be in [obj_lights] yet. Returns
+// stored record or `NULL` on failure.
+static ObjectLight* obj_light_insert(ObjectLight* light)
+{
+    // Keep load factor under 3/4.
+    if ((obj_lights_length + 1) * 4 > obj_lights_capacity * 3) {
+        if (obj_lights_grow() == -1) {
+            return NULL;
+        }
+    }
+
+    unsigned int mask = obj_lights_capacity - 1;
+    unsigned int pos = obj_light_hash(light->obj) & mask;
+    while (obj_lights[pos].obj != NULL) {
+        pos = (pos + 1) & mask;
+    }
 
-        x -= rect->lrx / 2;
-        y -= rect->lry / 2;
+    memcpy(&(obj_lights[pos]), light, sizeof(*light));
+    obj_lights_length++;
 
-        rectOffset(rect, x, y);
-        rect_min_bound(rect, &objectRect, rect);
+    return &(obj_lights[pos]);
+}
+
+// Removes [light] from [obj_lights] without changing light levels.
+static void obj_light_remove(ObjectLight* light)
+{
+    unsigned int mask = obj_lights_capacity - 1;
+    unsigned int hole = light - obj_lights;
+
+    // Shift following entries of the probe sequence back so lookups don't
+    // stop early at the freed slot.
+    unsigned int pos = (hole + 1) & mask;
+    while (obj_lights[pos].obj != NULL) {
+        unsigned int home = obj_light_hash(obj_lights[pos].obj) & mask;
+        if (((pos - home) & mask) >= ((pos - hole) & mask)) {
+            memcpy(&(obj_lights[hole]), &(obj_lights[pos]), sizeof(*obj_lights));
+            hole = pos;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    obj_lights[hole].obj = NULL;
+    obj_lights_length--;
+}
+
+static int obj_lights_grow()
+{
+    int capacity = obj_lights_capacity != 0 ? obj_lights_capacity * 2 : OBJECT_LIGHTS_INITIAL_CAPACITY;
+    ObjectLight* lights = (ObjectLight*)mem_malloc(sizeof(*lights) * capacity);
+    if (lights == NULL) {
+        return -1;
+    }
+
+    for (int index = 0; index < capacity; index++) {
+        lights[index].obj = NULL;
     }
 
+    unsigned int mask = capacity - 1;
+    for (int index = 0; index < obj_lights_capacity; index++) {
+        if (obj_lights[index].obj != NULL) {
+            unsigned int pos = obj_light_hash(obj_lights[index].obj) & mask;
+            while (lights[pos].obj != NULL) {
+                pos = (pos + 1) & mask;
+            }
+            memcpy(&(lights[pos]), &(obj_lights[index]), sizeof(*lights));
+        }
+    }
+
+    if (obj_lights != NULL) {
+        mem_free(obj_lights);
+    }
+
+    obj_lights = lights;
+    obj_lights_capacity = capacity;
+
     return 0;
 }
 
+// Forgets all light records, used when tile light levels are reset.
+static void obj_lights_clear()
+{
+    for (int index = 0; index < obj_lights_capacity; index++) {
+        obj_lights[index].obj = NULL;
+    }
+    obj_lights_length = 0;
+}
+
+static void obj_lights_free()
+{
+    if (obj_lights != NULL) {
+        mem_free(obj_lights);
+        obj_lights = NULL;
+    }
+
+    obj_lights_capacity = 0;
+    obj_lights_length = 0;
+}
+
+// Returns uninitialized item from [pool], or `NULL` if out of memory.
+static void* obj_pool_alloc(ObjectPool* pool)
+{
+    if (pool->freeList == NULL) {
+        ObjectPoolSlab* slab = (ObjectPoolSlab*)mem_malloc(sizeof(*slab) + (pool->itemSize + 1) * pool->slabLength);
+        if (slab == NULL) {
+            return NULL;
+        }
+
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+        pool->slabCount++;
+
+        // Thread items in address order, so consecutive allocations are
+        // adjacent in memory.
+        unsigned char* items = (unsigned char*)(slab + 1);
+        for (int index = pool->slabLength - 1; index >= 0; index--) {
+            void* item = items + pool->itemSize * index;
+            *(void**)item = pool->freeList;
+            pool->freeList = item;
+        }
+
+        if (obj_pool_check) {
+            for (int index = 0; index < pool->slabLength; index++) {
+                unsigned char* item = items + pool->itemSize * index;
+                memset(item + sizeof(void*), OBJECT_POOL_FREE_FILL, pool->itemSize - sizeof(void*));
+            }
+            memset(items + pool->itemSize * pool->slabLength, 1, pool->slabLength);
+        }
+    }
+
+    unsigned char* item = (unsigned char*)pool->freeList;
+    pool->freeList = *(void**)item;
+
+    if (obj_pool_check) {
+        *obj_pool_free_flag(pool, item) = 0;
+
+        for (size_t offset = sizeof(void*); offset < pool->itemSize; offset++) {
+            if (item[offset] != OBJECT_POOL_FREE_FILL) {
+                debug_printf("obj_pool_alloc: %s item %p was written to after being freed.\n", pool->name, item);
+                break;
+            }
+        }
+    }
+
+    pool->used++;
+    if (pool->used > pool->peak) {
+        pool->peak = pool->used;
+    }
+    pool->allocations++;
+
+    return item;
+}
+
+// Returns [item] to [pool].
+static void obj_pool_free(ObjectPool* pool, void* item)
+{
+    if (obj_pool_check) {
+        unsigned char* freeFlag = obj_pool_free_flag(pool, item);
+        if (freeFlag == NULL) {
+            debug_printf("obj_pool_free: %p is not in %s pool.\n", item, pool->name);
+            return;
+        }
+
+        if (*freeFlag != 0) {
+            debug_printf("obj_pool_free: %s item %p is already free.\n", pool->name, item);
+            return;
+        }
+
+        *freeFlag = 1;
+
+        memset((unsigned char*)item + sizeof(void*), OBJECT_POOL_FREE_FILL, pool->itemSize - sizeof(void*));
+    }
+
+    *(void**)item = pool->freeList;
+    pool->freeList = item;
+    pool->used--;
+}
+
+// Returns free flag of [item], or `NULL` if [item] is not the start of an
+// item in one of [pool] slabs.
+static unsigned char* obj_pool_free_flag(ObjectPool* pool, void* item)
+{
+    ObjectPoolSlab* slab = pool->slabs;
+    while (slab != NULL) {
+        unsigned char* items = (unsigned char*)(slab + 1);
+        unsigned char* end = items + pool->itemSize * pool->slabLength;
+        if ((unsigned char*)item >= items && (unsigned char*)item < end) {
+            size_t offset = (unsigned char*)item - items;
+            if (offset % pool->itemSize != 0) {
+                return NULL;
+            }
+            return end + offset / pool->itemSize;
+        }
+        slab = slab->next;
+    }
+
+    return NULL;
+}
+
+// Poisons and flags every free item in [pool], so checks do not trip over
+// items freed before [obj_pool_check] was enabled.
+static void obj_pool_fill(ObjectPool* pool)
+{
+    ObjectPoolSlab* slab = pool->slabs;
+    while (slab != NULL) {
+        unsigned char* items = (unsigned char*)(slab + 1);
+        memset(items + pool->itemSize * pool->slabLength, 0, pool->slabLength);
+        slab = slab->next;
+    }
+
+    void* item = pool->freeList;
+    while (item != NULL) {
+        memset((unsigned char*)item + sizeof(void*), OBJECT_POOL_FREE_FILL, pool->itemSize - sizeof(void*));
+        *obj_pool_free_flag(pool, item) = 1;
+        item = *(void**)item;
+    }
+}
+
+// Frees [pool] slabs, provided none of its items are in use.
+static void obj_pool_release(ObjectPool* pool)
+{
+    if (pool->used != 0) {
+        debug_printf("obj_pool_release: %d %s still in use.\n", pool->used, pool->name);
+        return;
+    }
+
+    ObjectPoolSlab* slab = pool->slabs;
+    while (slab != NULL) {
+        ObjectPoolSlab* next = slab->next;
+        mem_free(slab);
+        slab = next;
+    }
+
+    pool->slabs = NULL;
+    pool->freeList = NULL;
+    pool->slabCount = 0;
+}
+
+// Enables or disables use-after-free checks of object and node pools.
+void obj_pool_set_check(bool enabled)
+{
+    if (enabled && !obj_pool_check) {
+        obj_pool_fill(&obj_object_pool);
+        obj_pool_fill(&obj_node_pool);
+    }
+
+    obj_pool_check = enabled;
+}
+
+// Prints object and node pool usage into [dest] and resets allocation
+// counters. Slab count is the number of heap blocks backing the pool, every
+// other allocation would be a heap block of its own without it.
+bool obj_pool_stats(char* dest)
+{
+    if (dest == NULL) {
+        return false;
+    }
+
+    sprintf(dest,
+        "Object pool: %d allocations, %d used, %d peak, %d slabs.\n"
+        "Node pool: %d allocations, %d used, %d peak, %d slabs.\n"
+        "Last obj_remove_all: %u ms.\n",
+        obj_object_pool.allocations,
+        obj_object_pool.used,
+        obj_object_pool.peak,
+        obj_object_pool.slabCount,
+        obj_node_pool.allocations,
+        obj_node_pool.used,
+        obj_node_pool.peak,
+        obj_node_pool.slabCount,
+        obj_remove_all_time);
+
+    obj_object_pool.allocations = 0;
+    obj_node_pool.allocations = 0;
+
+    return true;
+}
+
+// Returns buffer of at least [size] bytes for short-lived query results,
+// reusing one of [obj_scratch_cache] when possible. Release it with
+// [obj_scratch_free].
+static void* obj_scratch_alloc(size_t size)
+{
+    int best = -1;
+    for (int index = 0; index < OBJECT_SCRATCH_CACHE_SIZE; index++) {
+        ObjectScratchHeader* header = obj_scratch_cache[index];
+        if (header != NULL && header->size >= size) {
+            if (best == -1 || header->size < obj_scratch_cache[best]->size) {
+                best = index;
+            }
+        }
+    }
+
+    if (best != -1) {
+        ObjectScratchHeader* header = obj_scratch_cache[best];
+        obj_scratch_cache[best] = NULL;
+        return header + 1;
+    }
+
+    size_t capacity = OBJECT_SCRATCH_MIN_SIZE;
+    while (capacity < size) {
+        capacity *= 2;
+    }
+
+    ObjectScratchHeader* header = (ObjectScratchHeader*)mem_malloc(sizeof(*header) + capacity);
+    if (header == NULL) {
+        return NULL;
+    }
+
+    header->size = capacity;
+
+    return header + 1;
+}
+
+// Keeps [ptr] for reuse, replacing the smallest cached buffer if the cache is
+// full.
+static void obj_scratch_free(void* ptr)
+{
+    ObjectScratchHeader* header = (ObjectScratchHeader*)ptr - 1;
+
+    int smallest = 0;
+    for (int index = 0; index < OBJECT_SCRATCH_CACHE_SIZE; index++) {
+        if (obj_scratch_cache[index] == NULL) {
+            obj_scratch_cache[index] = header;
+            return;
+        }
+
+        if (obj_scratch_cache[index]->size < obj_scratch_cache[smallest]->size) {
+            smallest = index;
+        }
+    }
+
+    if (obj_scratch_cache[smallest]->size < header->size) {
+        mem_free(obj_scratch_cache[smallest]);
+        obj_scratch_cache[smallest] = header;
+    } else {
+        mem_free(header);
+    }
+}
+
+static void obj_scratch_exit()
+{
+    for (int index = 0; index < OBJECT_SCRATCH_CACHE_SIZE; index++) {
+        if (obj_scratch_cache[index] != NULL) {
+            mem_free(obj_scratch_cache[index]);
+            obj_scratch_cache[index] = NULL;
+        }
+    }
+}
+
 // 0x4801A0
 static void obj_render_outline(Object* object, Rect* rect)
 {
@@ -4606,8 +5730,13 @@ static void obj_render_object(Object* object, Rect* rect, int light)
         return;
     }
 
-    int frameWidth = art_frame_width(art, object->frame, object->rotation);
-    int frameHeight = art_frame_length(art, object->frame, object->rotation);
+    int frameWidth;
+    int frameHeight;
+    unsigned char* src;
+    if (art_frame_info(art, object->frame, object->rotation, &frameWidth, &frameHeight, &src, NULL, NULL) == -1) {
+        art_ptr_unlock(cacheEntry);
+        return;
+    }
 
     Rect objectRect;
     if (object->tile == -1) {
@@ -4642,7 +5771,6 @@ static void obj_render_object(Object* object, Rect* rect, int light)
         return;
     }
 
-    unsigned char* src = art_frame_data(art, object->frame, object->rotation);
     unsigned char* src2 = src;
     int v50 = objectRect.ulx - object->sx;
     int v49 = objectRect.uly - object->sy;
@@ -4650,13 +5778,21 @@ static void obj_render_object(Object* object, Rect* rect, int light)
     int objectWidth = objectRect.lrx - objectRect.ulx + 1;
     int objectHeight = objectRect.lry - objectRect.uly + 1;
 
+    // Opaque spans built when art was loaded, lets blitters skip transparent
+    // pixels altogether.
+    int* spanRows = art_frame_spans(art, object->frame, object->rotation);
+
     if (type == 6) {
-        trans_buf_to_buf(src,
-            objectWidth,
-            objectHeight,
-            frameWidth,
-            back_buf + buf_full * objectRect.uly + objectRect.ulx,
-            buf_full);
+        if (spanRows != NULL) {
+            trans_spans_to_buf(src2, frameWidth, frameHeight, spanRows, v50, v49, objectWidth, objectHeight, back_buf, objectRect.ulx, objectRect.uly, buf_full);
+        } else {
+            trans_buf_to_buf(src,
+                objectWidth,
+                objectHeight,
+                frameWidth,
+                back_buf + buf_full * objectRect.uly + objectRect.ulx,
+                buf_full);
+        }
         art_ptr_unlock(cacheEntry);
         return;
     }
@@ -4779,27 +5915,43 @@ static void obj_render_object(Object* object, Rect* rect, int light)
         }
     }
 
+    unsigned char* blendTable = NULL;
+    unsigned char* grayTable = commonGrayTable;
+
     switch (object->flags & OBJECT_FLAG_0xFC000) {
     case OBJECT_TRANS_RED:
-        dark_translucent_trans_buf_to_buf(src, objectWidth, objectHeight, frameWidth, back_buf, objectRect.ulx, objectRect.uly, buf_full, light, redBlendTable, commonGrayTable);
+        blendTable = redBlendTable;
         break;
     case OBJECT_TRANS_WALL:
-        dark_translucent_trans_buf_to_buf(src, objectWidth, objectHeight, frameWidth, back_buf, objectRect.ulx, objectRect.uly, buf_full, 0x10000, wallBlendTable, commonGrayTable);
+        blendTable = wallBlendTable;
+        light = 0x10000;
         break;
     case OBJECT_TRANS_GLASS:
-        dark_translucent_trans_buf_to_buf(src, objectWidth, objectHeight, frameWidth, back_buf, objectRect.ulx, objectRect.uly, buf_full, light, glassBlendTable, glassGrayTable);
+        blendTable = glassBlendTable;
+        grayTable = glassGrayTable;
         break;
     case OBJECT_TRANS_STEAM:
-        dark_translucent_trans_buf_to_buf(src, objectWidth, objectHeight, frameWidth, back_buf, objectRect.ulx, objectRect.uly, buf_full, light, steamBlendTable, commonGrayTable);
+        blendTable = steamBlendTable;
         break;
     case OBJECT_TRANS_ENERGY:
-        dark_translucent_trans_buf_to_buf(src, objectWidth, objectHeight, frameWidth, back_buf, objectRect.ulx, objectRect.uly, buf_full, light, energyBlendTable, commonGrayTable);
-        break;
-    default:
-        dark_trans_buf_to_buf(src, objectWidth, objectHeight, frameWidth, back_buf, objectRect.ulx, objectRect.uly, buf_full, light);
+        blendTable = energyBlendTable;
         break;
     }
 
+    if (blendTable != NULL) {
+        if (spanRows != NULL) {
+            dark_translucent_trans_spans_to_buf(src2, frameWidth, frameHeight, spanRows, v50, v49, objectWidth, objectHeight, back_buf, objectRect.ulx, objectRect.uly, buf_full, light, blendTable, grayTable);
+        } else {
+            dark_translucent_trans_buf_to_buf(src, objectWidth, objectHeight, frameWidth, back_buf, objectRect.ulx, objectRect.uly, buf_full, light, blendTable, grayTable);
+        }
+    } else {
+        if (spanRows != NULL) {
+            dark_trans_spans_to_buf(src2, frameWidth, frameHeight, spanRows, v50, v49, objectWidth, objectHeight, back_buf, objectRect.ulx, objectRect.uly, buf_full, light);
+        } else {
+            dark_trans_buf_to_buf(src, objectWidth, objectHeight, frameWidth, back_buf, objectRect.ulx, objectRect.uly, buf_full, light);
+        }
+    }
+
     art_ptr_unlock(cacheEntry);
 }
 
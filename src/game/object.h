@@ -7,6 +7,13 @@
 #include "plib/db/db.h"
 #include "plib/gnw/rect.h"
 
+typedef enum ObjectBlocking {
+    OBJECT_BLOCKING_MOVE,
+    OBJECT_BLOCKING_SIGHT,
+    OBJECT_BLOCKING_SHOOT,
+    OBJECT_BLOCKING_COUNT,
+} ObjectBlocking;
+
 typedef struct ObjectWithFlags {
     int flags;
     Object* object;
@@ -47,6 +54,10 @@ int obj_set_rotation(Object* obj, int direction, Rect* rect);
 int obj_inc_rotation(Object* obj, Rect* rect);
 int obj_dec_rotation(Object* obj, Rect* rect);
 void obj_rebuild_all_light();
+int obj_light_tile_changed(int tile, int elevation, Rect* rect);
+bool obj_light_validate();
+void obj_pool_set_check(bool enabled);
+bool obj_pool_stats(char* dest);
 int obj_set_light(Object* obj, int lightDistance, int lightIntensity, Rect* rect);
 int obj_get_visible_light(Object* obj);
 int obj_turn_on_light(Object* obj, Rect* rect);
@@ -67,6 +78,10 @@ Object* obj_find_first_at(int elevation);
 Object* obj_find_next_at();
 void obj_bound(Object* obj, Rect* rect);
 bool obj_occupied(int tile_num, int elev);
+unsigned int obj_blocking_epoch(int elevation);
+void obj_blocking_changed(Object* obj);
+bool obj_blocking_possible(ObjectBlocking blocking, int tile, int elevation);
+bool obj_blocking_validate();
 Object* obj_blocking_at(Object* a1, int tile_num, int elev);
 int obj_scroll_blocking_at(int tile_num, int elev);
 Object* obj_sight_blocking_at(Object* a1, int tile_num, int elev);
@@ -77,6 +92,9 @@ void translucent_trans_buf_to_buf(unsigned char* src, int srcWidth, int srcHeigh
 void dark_trans_buf_to_buf(unsigned char* src, int srcWidth, int srcHeight, int srcPitch, unsigned char* dest, int destX, int destY, int destPitch, int light);
 void dark_translucent_trans_buf_to_buf(unsigned char* src, int srcWidth, int srcHeight, int srcPitch, unsigned char* dest, int destX, int destY, int destPitch, int light, unsigned char* a10, unsigned char* a11);
 void intensity_mask_buf_to_buf(unsigned char* src, int srcWidth, int srcHeight, int srcPitch, unsigned char* dest, int destPitch, unsigned char* mask, int maskPitch, int light);
+void trans_spans_to_buf(unsigned char* src, int srcPitch, int frameHeight, int* rows, int srcX, int srcY, int srcWidth, int srcHeight, unsigned char* dest, int destX, int destY, int destPitch);
+void dark_trans_spans_to_buf(unsigned char* src, int srcPitch, int frameHeight, int* rows, int srcX, int srcY, int srcWidth, int srcHeight, unsigned char* dest, int destX, int destY, int destPitch, int light);
+void dark_translucent_trans_spans_to_buf(unsigned char* src, int srcPitch, int frameHeight, int* rows, int srcX, int srcY, int srcWidth, int srcHeight, unsigned char* dest, int destX, int destY, int destPitch, int light, unsigned char* a10, unsigned char* a11);
 int obj_outline_object(Object* obj, int a2, Rect* rect);
 int obj_remove_outline(Object* obj, Rect* rect);
 int obj_intersects_with(Object* object, int x, int y);
@@ -273,6 +273,9 @@ static_assert(sizeof(Object) == 132, "wrong size");
 typedef struct ObjectListNode {
     Object* obj;
     struct ObjectListNode* next;
+
+    // Blocking contribution of [obj] recorded when it was linked to its tile.
+    int blocking;
 } ObjectListNode;
 
 #define BUILT_TILE_TILE_MASK 0x3FFFFFF
@@ -4,6 +4,7 @@
 
 #include "game/cycle.h"
 #include "game/gsound.h"
+#include "game/tile.h"
 #include "plib/color/color.h"
 #include "plib/gnw/debug.h"
 #include "plib/gnw/input.h"
@@ -65,6 +66,8 @@ void palette_exit()
 // 0x485164
 void palette_fade_to(unsigned char* palette)
 {
+    tile_flush_refresh_rects();
+
     bool colorCycleWasEnabled = cycle_is_enabled();
     cycle_disable();
 
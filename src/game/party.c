@@ -104,7 +104,7 @@ int partyMemberAdd(Object* object)
         script->scr_oid = object->id;
 
         object->sid = ((object->pid & 0xFFFFFF) + 18000) | (SCRIPT_TYPE_CRITTER << 24);
-        script->scr_id = object->sid;
+        scr_change_id(script->scr_id, object->sid);
     }
 
     combatai_switch_team(object, 0);
@@ -321,7 +321,7 @@ int partyMemberRecoverLoad()
             memcpy(script, partyMember->script, sizeof(*script));
 
             partyMember->object->sid = ((partyMember->object->pid & 0xFFFFFF) + 18000) | (SCRIPT_TYPE_CRITTER << 24);
-            script->scr_id = partyMember->object->sid;
+            scr_change_id(sid, partyMember->object->sid);
 
             script->program = NULL;
             script->scr_flags &= ~(SCRIPT_FLAG_0x01 | SCRIPT_FLAG_0x04);
@@ -712,7 +712,7 @@ static int partyMemberItemRecover(PartyMember* partyMember)
     memcpy(script, partyMember->script, sizeof(*script));
 
     partyMember->object->sid = partyMemberItemCount | (SCRIPT_TYPE_ITEM << 24);
-    script->scr_id = partyMemberItemCount | (SCRIPT_TYPE_ITEM << 24);
+    scr_change_id(sid, partyMemberItemCount | (SCRIPT_TYPE_ITEM << 24));
 
     script->program = NULL;
     script->scr_flags &= ~(SCRIPT_FLAG_0x01 | SCRIPT_FLAG_0x04 | SCRIPT_FLAG_0x08 | SCRIPT_FLAG_0x10);
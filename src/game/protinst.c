@@ -33,7 +33,7 @@ static int obj_use_book(Object* item_obj);
 static int obj_use_flare(Object* critter_obj, Object* item_obj);
 static int obj_use_explosive(Object* explosive);
 static int protinst_default_use_item(Object* a1, Object* a2, Object* item);
-static int rebuild_all_light();
+static void door_light_changed(Object* door);
 static int set_door_state_open(Object* a1, Object* a2);
 static int set_door_state_closed(Object* a1, Object* a2);
 static int check_door_state(Object* a1, Object* a2);
@@ -1079,12 +1079,15 @@ int obj_use_item_on(Object* a1, Object* a2, Object* a3)
     return rc;
 }
 
-// 0x48B63C
-static int rebuild_all_light()
+// Re-evaluates only lights reaching [door] after it was opened or closed and
+// refreshes area they cover. Original code rebuilt every light on the map
+// here (`rebuild_all_light` at 0x48B63C).
+static void door_light_changed(Object* door)
 {
-    obj_rebuild_all_light();
-    tile_refresh_display();
-    return 0;
+    Rect rect;
+    if (obj_light_tile_changed(door->tile, door->elevation, &rect) == 0) {
+        tile_refresh_rect(&rect, door->elevation);
+    }
 }
 
 // 0x48B64C
@@ -1195,9 +1198,8 @@ static int check_door_state(Object* a1, Object* a2)
 {
     if ((a1->data.scenery.door.openFlags & 0x01) == 0) {
         a1->flags &= ~OBJECT_OPEN_DOOR;
-
-        // NOTE: Uninline.
-        rebuild_all_light();
+        obj_blocking_changed(a1);
+        door_light_changed(a1);
 
         if (a1->frame == 0) {
             return 0;
@@ -1230,9 +1232,8 @@ static int check_door_state(Object* a1, Object* a2)
         return 0;
     } else {
         a1->flags |= OBJECT_OPEN_DOOR;
-
-        // NOTE: Uninline.
-        rebuild_all_light();
+        obj_blocking_changed(a1);
+        door_light_changed(a1);
 
         CacheEntry* artHandle;
         Art* art = art_ptr_lock(a1->fid, &artHandle);
@@ -1537,6 +1538,7 @@ int obj_lock(Object* object)
         break;
     case OBJ_TYPE_SCENERY:
         object->data.scenery.door.openFlags |= OBJ_LOCKED;
+        obj_blocking_changed(object);
         break;
     default:
         return -1;
@@ -1558,6 +1560,7 @@ int obj_unlock(Object* object)
         return 0;
     case OBJ_TYPE_SCENERY:
         object->data.scenery.door.openFlags &= ~OBJ_LOCKED;
+        obj_blocking_changed(object);
         return 0;
     }
 
@@ -1769,6 +1772,7 @@ int obj_attempt_placement(Object* obj, int tile, int elevation, int a4)
     }
 
     obj->flags &= ~OBJECT_HIDDEN;
+    obj_blocking_changed(obj);
 
     Rect temp;
     if (obj_move_to_tile(obj, newTile, elevation, &temp) != -1) {
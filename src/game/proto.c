@@ -24,8 +24,30 @@
 #include "game/trait.h"
 #include "int/dialog.h"
 #include "plib/gnw/debug.h"
+#include "plib/gnw/input.h"
 #include "plib/gnw/memory.h"
 
+#define PROTO_INDEX_INITIAL_CAPACITY 512
+
+// Entry of [proto_index]. Unused entries have `pid` set to -1.
+typedef struct ProtoIndexEntry {
+    int pid;
+    Proto* proto;
+} ProtoIndexEntry;
+
+// Proto file names listed in .lst file of single proto type, see
+// [proto_list_load].
+typedef struct ProtoListNames {
+    // Offsets of names in [data] by line (zero-based).
+    int* offsets;
+    int length;
+    char* data;
+    bool loaded;
+
+    // Value of [db_generation] the list was read at.
+    unsigned int generation;
+} ProtoListNames;
+
 static char* proto_get_msg_info(int pid, int message);
 static int proto_read_CombatData(CritterCombatData* data, DB_FILE* stream);
 static int proto_write_CombatData(CritterCombatData* data, DB_FILE* stream);
@@ -36,6 +58,14 @@ static int proto_write_item_data(ItemProtoData* item_data, int type, DB_FILE* st
 static int proto_write_scenery_data(SceneryProtoData* scenery_data, int type, DB_FILE* stream);
 static int proto_write_protoSubNode(Proto* buf, DB_FILE* stream);
 static int proto_new_id(int a1);
+static unsigned int proto_index_hash(int pid);
+static Proto** proto_index_find(int pid);
+static int proto_index_grow();
+static int proto_index_set(int pid, Proto* proto);
+static void proto_index_clear();
+static void proto_index_free();
+static int proto_list_load(int type);
+static void proto_list_free(int type);
 
 // 0x50734C
 char cd_path_base[MAX_PATH];
@@ -73,6 +103,34 @@ static const size_t proto_sizes[11] = {
 // 0x50752C
 static int protos_been_initialized = 0;
 
+// Open-addressing table (linear probing) mapping pid of every proto cached in
+// [protolists] to the proto itself. Protos are only added by [proto_load_pid]
+// and only released all at once by [proto_remove_all], so there is no need to
+// support removing individual entries.
+static ProtoIndexEntry* proto_index = NULL;
+
+// Number of entries in [proto_index], always a power of two.
+static int proto_index_capacity = 0;
+
+// Number of used entries in [proto_index].
+static int proto_index_length = 0;
+
+// Number of [proto_ptr] calls since last [proto_index_stats].
+static int proto_index_lookups = 0;
+
+// Number of [proto_ptr] calls which had to load proto from disk since last
+// [proto_index_stats].
+static int proto_index_misses = 0;
+
+// Contents of .lst files of every proto type, so resolving pid to file name
+// doesn't need to scan the list.
+static ProtoListNames proto_list_names[6];
+
+// Number of .lst files [proto_list_load] read and time it spent reading them
+// (in ms) since last [proto_index_stats].
+static int proto_list_reads = 0;
+static unsigned int proto_list_read_time = 0;
+
 // 0x507530
 static CritterProto pc_proto = {
     0x1000000,
@@ -192,43 +250,136 @@ int proto_list_str(int pid, char* proto_path)
         return -1;
     }
 
+    int type = PID_TYPE(pid);
+    if (type < 0 || type >= 6) {
+        return -1;
+    }
+
+    ProtoListNames* list = &(proto_list_names[type]);
+    if (!list->loaded || list->generation != db_generation()) {
+        if (proto_list_load(type) == -1) {
+            return -1;
+        }
+    }
+
+    int index = (pid & 0xFFFFFF) - 1;
+
+    // NOTE: Original code scanned the list and used the last line it read
+    // if it ran out of lines exactly one line short.
+    if (index == list->length && list->length != 0) {
+        index = list->length - 1;
+    }
+
+    if (index < 0 || index >= list->length) {
+        return -1;
+    }
+
+    strcpy(proto_path, list->data + list->offsets[index]);
+
+    return 0;
+}
+
+// Reads .lst file of proto [type] into [proto_list_names]. Every line is
+// reduced to the file name the same way [proto_list_str] always did.
+static int proto_list_load(int type)
+{
+    ProtoListNames* list = &(proto_list_names[type]);
+    unsigned int start = get_time();
+
+    proto_list_free(type);
+
     char path[MAX_PATH];
-    proto_make_path(path, pid);
+    proto_make_path(path, type << 24);
     strcat(path, "\\");
-    strcat(path, art_dir(PID_TYPE(pid)));
+    strcat(path, art_dir(type));
     strcat(path, ".lst");
 
     DB_FILE* stream = db_fopen(path, "rt");
+    if (stream == NULL) {
+        return -1;
+    }
+
+    int offsetsCapacity = 0;
+    int dataLength = 0;
+    int dataCapacity = 0;
 
-    int i = 1;
     char string[256];
     while (db_fgets(string, sizeof(string), stream)) {
-        if (i == (pid & 0xFFFFFF)) {
-            break;
+        char* pch = strchr(string, ' ');
+        if (pch != NULL) {
+            *pch = '\0';
+        }
+
+        pch = strchr(string, '\n');
+        if (pch != NULL) {
+            *pch = '\0';
+        }
+
+        int size = strlen(string) + 1;
+
+        if (list->length == offsetsCapacity) {
+            int capacity = offsetsCapacity != 0 ? offsetsCapacity * 2 : 256;
+            int* offsets = (int*)mem_realloc(list->offsets, sizeof(*offsets) * capacity);
+            if (offsets == NULL) {
+                db_fclose(stream);
+                proto_list_free(type);
+                return -1;
+            }
+
+            list->offsets = offsets;
+            offsetsCapacity = capacity;
         }
 
-        i++;
+        if (dataLength + size > dataCapacity) {
+            int capacity = dataCapacity != 0 ? dataCapacity * 2 : 4096;
+            while (dataLength + size > capacity) {
+                capacity *= 2;
+            }
+
+            char* data = (char*)mem_realloc(list->data, capacity);
+            if (data == NULL) {
+                db_fclose(stream);
+                proto_list_free(type);
+                return -1;
+            }
+
+            list->data = data;
+            dataCapacity = capacity;
+        }
+
+        memcpy(list->data + dataLength, string, size);
+        list->offsets[list->length] = dataLength;
+        list->length++;
+        dataLength += size;
     }
 
     db_fclose(stream);
 
-    if (i != (pid & 0xFFFFFF)) {
-        return -1;
-    }
+    list->loaded = true;
+    list->generation = db_generation();
 
-    char* pch = strchr(string, ' ');
-    if (pch != NULL) {
-        *pch = '\0';
-    }
+    proto_list_reads++;
+    proto_list_read_time += elapsed_tocks(get_time(), start);
+
+    return 0;
+}
 
-    pch = strchr(string, '\n');
-    if (pch != NULL) {
-        *pch = '\0';
+static void proto_list_free(int type)
+{
+    ProtoListNames* list = &(proto_list_names[type]);
+
+    if (list->offsets != NULL) {
+        mem_free(list->offsets);
+        list->offsets = NULL;
     }
 
-    strcpy(proto_path, string);
+    if (list->data != NULL) {
+        mem_free(list->data);
+        list->data = NULL;
+    }
 
-    return 0;
+    list->length = 0;
+    list->loaded = false;
 }
 
 // 0x48CF90
@@ -778,6 +929,7 @@ int proto_dude_init(const char* path)
     proto->critter.data.bodyType = 0;
     proto->critter.data.experience = 0;
     proto->critter.data.killType = 0;
+    stat_cache_invalidate();
 
     proto_dude_update_gender();
     inven_reset_dude();
@@ -788,6 +940,7 @@ int proto_dude_init(const char* path)
 
     if ((obj_dude->flags & OBJECT_NO_BLOCK) != 0) {
         obj_dude->flags &= ~OBJECT_NO_BLOCK;
+        obj_blocking_changed(obj_dude);
     }
 
     stat_recalc_derived(obj_dude);
@@ -1167,6 +1320,11 @@ void proto_exit()
 
     // NOTE: Uninline.
     proto_remove_all();
+    proto_index_free();
+
+    for (i = 0; i < 6; i++) {
+        proto_list_free(i);
+    }
 
     protos_been_initialized = 0;
 
@@ -1217,6 +1375,8 @@ int proto_header_load()
         }
 
         db_fclose(stream);
+
+        proto_list_load(index);
     }
 
     return 0;
@@ -1646,6 +1806,13 @@ int proto_load_pid(int pid, Proto** protoPtr)
     }
 
     db_fclose(stream);
+
+    if (proto_index_set((*protoPtr)->pid, *protoPtr) == -1) {
+        return -1;
+    }
+
+    stat_cache_invalidate();
+
     return 0;
 }
 
@@ -1724,6 +1891,9 @@ void proto_remove_all()
         protoList->tail = NULL;
         protoList->length = 0;
     }
+
+    proto_index_clear();
+    stat_cache_invalidate();
 }
 
 // 0x4904AC
@@ -1740,20 +1910,176 @@ int proto_ptr(int pid, Proto** protoPtr)
         return 0;
     }
 
-    ProtoList* protoList = &(protolists[PID_TYPE(pid)]);
-    ProtoListExtent* protoListExtent = protoList->head;
-    while (protoListExtent != NULL) {
-        for (int index = 0; index < protoListExtent->length; index++) {
-            Proto* proto = (Proto*)protoListExtent->proto[index];
-            if (pid == proto->pid) {
-                *protoPtr = proto;
-                return 0;
+    proto_index_lookups++;
+
+    Proto** cached = proto_index_find(pid);
+    if (cached != NULL) {
+        *protoPtr = *cached;
+        return 0;
+    }
+
+    proto_index_misses++;
+
+    return proto_load_pid(pid, protoPtr);
+}
+
+static unsigned int proto_index_hash(int pid)
+{
+    // Object type lives in the high byte, mix it into the low bits.
+    unsigned int hash = (unsigned int)pid;
+    hash ^= hash >> 16;
+    hash *= 0x45D9F3B;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+// Returns pointer to cached proto for [pid] in [proto_index], or NULL if it
+// has not been loaded yet.
+static Proto** proto_index_find(int pid)
+{
+    if (proto_index_length == 0) {
+        return NULL;
+    }
+
+    unsigned int mask = proto_index_capacity - 1;
+    unsigned int pos = proto_index_hash(pid) & mask;
+    while (proto_index[pos].pid != -1) {
+        if (proto_index[pos].pid == pid) {
+            return &(proto_index[pos].proto);
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    return NULL;
+}
+
+// Doubles [proto_index] capacity and rehashes existing entries.
+static int proto_index_grow()
+{
+    int capacity = proto_index_capacity != 0 ? proto_index_capacity * 2 : PROTO_INDEX_INITIAL_CAPACITY;
+    ProtoIndexEntry* entries = (ProtoIndexEntry*)mem_malloc(sizeof(*entries) * capacity);
+    if (entries == NULL) {
+        debug_printf("\nError: proto_index_grow: out of memory!");
+        return -1;
+    }
+
+    for (int index = 0; index < capacity; index++) {
+        entries[index].pid = -1;
+        entries[index].proto = NULL;
+    }
+
+    ProtoIndexEntry* oldEntries = proto_index;
+    int oldCapacity = proto_index_capacity;
+
+    proto_index = entries;
+    proto_index_capacity = capacity;
+    proto_index_length = 0;
+
+    for (int index = 0; index < oldCapacity; index++) {
+        if (oldEntries[index].pid != -1) {
+            proto_index_set(oldEntries[index].pid, oldEntries[index].proto);
+        }
+    }
+
+    if (oldEntries != NULL) {
+        mem_free(oldEntries);
+    }
+
+    return 0;
+}
+
+// Points [pid] at [proto], adding it to [proto_index] if needed.
+static int proto_index_set(int pid, Proto* proto)
+{
+    if ((proto_index_length + 1) * 2 > proto_index_capacity) {
+        if (proto_index_grow() == -1) {
+            return -1;
+        }
+    }
+
+    unsigned int mask = proto_index_capacity - 1;
+    unsigned int pos = proto_index_hash(pid) & mask;
+    while (proto_index[pos].pid != -1) {
+        if (proto_index[pos].pid == pid) {
+            proto_index[pos].proto = proto;
+            return 0;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    proto_index[pos].pid = pid;
+    proto_index[pos].proto = proto;
+    proto_index_length++;
+
+    return 0;
+}
+
+static void proto_index_clear()
+{
+    for (int index = 0; index < proto_index_capacity; index++) {
+        proto_index[index].pid = -1;
+        proto_index[index].proto = NULL;
+    }
+
+    proto_index_length = 0;
+}
+
+static void proto_index_free()
+{
+    if (proto_index != NULL) {
+        mem_free(proto_index);
+        proto_index = NULL;
+    }
+
+    proto_index_capacity = 0;
+    proto_index_length = 0;
+}
+
+// Prints number of [proto_ptr] lookups and disk loads since last call into
+// [dest] and resets the counters.
+bool proto_index_stats(char* dest)
+{
+    if (dest == NULL) {
+        return false;
+    }
+
+    sprintf(dest, "Proto index: %d lookups, %d loaded, %d protos cached, %d lists read in %u ms.\n", proto_index_lookups, proto_index_misses, proto_index_length, proto_list_reads, proto_list_read_time);
+    proto_index_lookups = 0;
+    proto_index_misses = 0;
+    proto_list_reads = 0;
+    proto_list_read_time = 0;
+
+    return true;
+}
+
+// Cross-checks [proto_index] against a full scan of [protolists].
+bool proto_index_validate()
+{
+    int count = 0;
+    bool valid = true;
+
+    for (int type = 0; type < 6; type++) {
+        ProtoListExtent* extent = protolists[type].head;
+        while (extent != NULL) {
+            for (int index = 0; index < extent->length; index++) {
+                Proto* proto = extent->proto[index];
+                Proto** cached = proto_index_find(proto->pid);
+                if (cached == NULL || *cached != proto) {
+                    debug_printf("\nError: proto_index_validate: proto %x is not indexed", proto->pid);
+                    valid = false;
+                }
+                count++;
             }
+            extent = extent->next;
         }
-        protoListExtent = protoListExtent->next;
     }
 
-    return proto_load_pid(pid, protoPtr);
+    if (count != proto_index_length) {
+        debug_printf("\nError: proto_index_validate: %d protos, %d indexed", count, proto_index_length);
+        valid = false;
+    }
+
+    return valid;
 }
 
 // 0x490530
@@ -141,6 +141,8 @@ int proto_load_pid(int pid, Proto** out_proto);
 int proto_find_free_subnode(int type, Proto** out_ptr);
 void proto_remove_all();
 int proto_ptr(int pid, Proto** out_proto);
+bool proto_index_stats(char* dest);
+bool proto_index_validate();
 int proto_undo_new_id(int type);
 int proto_max_id(int a1);
 int ResetPlayer();
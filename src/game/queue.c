@@ -1,5 +1,9 @@
 #include "game/queue.h"
 
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "game/actions.h"
 #include "game/critter.h"
 #include "game/display.h"
@@ -13,17 +17,60 @@
 #include "game/protinst.h"
 #include "game/proto.h"
 #include "game/scripts.h"
+#include "plib/gnw/debug.h"
 #include "plib/gnw/memory.h"
 
+#define QUEUE_HEAP_INITIAL_CAPACITY 64
+#define QUEUE_OWNER_INDEX_INITIAL_CAPACITY 64
+
 typedef struct QueueListNode {
     // TODO: Make unsigned.
     int time;
     int type;
     Object* owner;
     void* data;
-    struct QueueListNode* next;
+
+    // Order in which events were queued, breaks ties between events
+    // scheduled for the same time so they are processed first-in first-out.
+    unsigned int seq;
+
+    // Index in [queue_heap].
+    int heapIndex;
+
+    // Slot of this event in the snapshot taken by [queue_clear_type], or
+    // NULL. Cleared when the event is unlinked or freed so the snapshot never
+    // refers to an event that is no longer queued.
+    struct QueueListNode** clearSlot;
+
+    // Siblings among events of the same owner, see [queue_owner_index].
+    struct QueueListNode* ownerPrev;
+    struct QueueListNode* ownerNext;
+
+    // Siblings among events of the same type, see [queue_type_lists].
+    struct QueueListNode* typePrev;
+    struct QueueListNode* typeNext;
 } QueueListNode;
 
+// An entry of [queue_owner_index].
+typedef struct QueueOwnerEntry {
+    Object* owner;
+
+    // First event of [owner], or NULL if this entry is unused.
+    QueueListNode* head;
+} QueueOwnerEntry;
+
+static int queue_insert(QueueListNode* node);
+static void queue_unlink(QueueListNode* node);
+static void queue_free_node(QueueListNode* node);
+static void queue_clear_type_in_place(int eventType, QueueEventHandler* fn);
+static bool queue_node_before(QueueListNode* a, QueueListNode* b);
+static void queue_heap_sift_up(int index);
+static void queue_heap_sift_down(int index);
+static int queue_heap_grow();
+static unsigned int queue_owner_hash(Object* owner);
+static QueueOwnerEntry* queue_owner_find(Object* owner);
+static int queue_owner_grow();
+static int queue_save_compare(const void* a1, const void* a2);
 static int queue_destroy(Object* obj, void* data);
 static int queue_explode(Object* obj, void* data);
 static int queue_explode_exit(Object* obj, void* data);
@@ -47,13 +94,37 @@ EventTypeDescription q_func[EVENT_TYPE_COUNT] = {
     { scr_map_q_process, NULL, NULL, NULL, true, NULL },
 };
 
-// 0x662F4C
-static QueueListNode* queue;
+// Binary min-heap of all queued events ordered by time (and [seq]), so
+// [queue_heap][0] is always the next event to process.
+static QueueListNode** queue_heap = NULL;
+static int queue_heap_length = 0;
+static int queue_heap_capacity = 0;
+
+// Open-addressing table (linear probing) mapping owners to lists of their
+// events, so per-owner lookups and removals do not need to scan entire queue.
+static QueueOwnerEntry* queue_owner_index = NULL;
+
+// Number of entries in [queue_owner_index], always a power of two.
+static int queue_owner_capacity = 0;
+
+// Number of used entries in [queue_owner_index].
+static int queue_owner_length = 0;
+
+// Lists of queued events by event type.
+static QueueListNode* queue_type_lists[EVENT_TYPE_COUNT];
+
+// Sequence number of next queued event.
+static unsigned int queue_next_seq = 0;
 
 // 0x490670
 void queue_init()
 {
-    queue = NULL;
+    queue_heap_length = 0;
+    queue_owner_length = 0;
+
+    for (int index = 0; index < EVENT_TYPE_COUNT; index++) {
+        queue_type_lists[index] = NULL;
+    }
 }
 
 // 0x490680
@@ -67,6 +138,19 @@ int queue_reset()
 int queue_exit()
 {
     queue_clear();
+
+    if (queue_heap != NULL) {
+        mem_free(queue_heap);
+        queue_heap = NULL;
+    }
+    queue_heap_capacity = 0;
+
+    if (queue_owner_index != NULL) {
+        mem_free(queue_owner_index);
+        queue_owner_index = NULL;
+    }
+    queue_owner_capacity = 0;
+
     return 0;
 }
 
@@ -78,9 +162,7 @@ int queue_load(DB_FILE* stream)
         return -1;
     }
 
-    queue = NULL;
-
-    QueueListNode** nextPtr = &queue;
+    queue_clear();
 
     int rc = 0;
     for (int index = 0; index < count; index += 1) {
@@ -136,25 +218,20 @@ int queue_load(DB_FILE* stream)
             queueListNode->data = NULL;
         }
 
-        queueListNode->next = NULL;
+        // Events are saved in processing order, so sequence numbers given in
+        // file order keep that order for events with the same time.
+        queueListNode->seq = queue_next_seq++;
+        queueListNode->clearSlot = NULL;
 
-        *nextPtr = queueListNode;
-        nextPtr = &(queueListNode->next);
+        if (queue_insert(queueListNode) == -1) {
+            queue_free_node(queueListNode);
+            rc = -1;
+            break;
+        }
     }
 
     if (rc == -1) {
-        while (queue != NULL) {
-            QueueListNode* next = queue->next;
-
-            EventTypeDescription* eventTypeDescription = &(q_func[queue->type]);
-            if (eventTypeDescription->freeProc != NULL) {
-                eventTypeDescription->freeProc(queue->data);
-            }
-
-            mem_free(queue);
-
-            queue = next;
-        }
+        queue_clear();
     }
 
     return rc;
@@ -163,48 +240,56 @@ int queue_load(DB_FILE* stream)
 // 0x4907F4
 int queue_save(DB_FILE* stream)
 {
-    QueueListNode* queueListNode;
-
-    int count = 0;
+    if (db_fwriteInt(stream, queue_heap_length) == -1) {
+        return -1;
+    }
 
-    queueListNode = queue;
-    while (queueListNode != NULL) {
-        count += 1;
-        queueListNode = queueListNode->next;
+    if (queue_heap_length == 0) {
+        return 0;
     }
 
-    if (db_fwriteInt(stream, count) == -1) {
+    // Save in processing order.
+    QueueListNode** nodes = (QueueListNode**)mem_malloc(sizeof(*nodes) * queue_heap_length);
+    if (nodes == NULL) {
         return -1;
     }
 
-    queueListNode = queue;
-    while (queueListNode != NULL) {
+    memcpy(nodes, queue_heap, sizeof(*nodes) * queue_heap_length);
+    qsort(nodes, queue_heap_length, sizeof(*nodes), queue_save_compare);
+
+    int rc = 0;
+    for (int index = 0; index < queue_heap_length; index++) {
+        QueueListNode* queueListNode = nodes[index];
         Object* object = queueListNode->owner;
         int objectId = object != NULL ? object->id : -2;
 
         if (db_fwriteInt(stream, queueListNode->time) == -1) {
-            return -1;
+            rc = -1;
+            break;
         }
 
         if (db_fwriteInt(stream, queueListNode->type) == -1) {
-            return -1;
+            rc = -1;
+            break;
         }
 
         if (db_fwriteInt(stream, objectId) == -1) {
-            return -1;
+            rc = -1;
+            break;
         }
 
         EventTypeDescription* eventTypeDescription = &(q_func[queueListNode->type]);
         if (eventTypeDescription->writeProc != NULL) {
             if (eventTypeDescription->writeProc(stream, queueListNode->data) == -1) {
-                return -1;
+                rc = -1;
+                break;
             }
         }
-
-        queueListNode = queueListNode->next;
     }
 
-    return 0;
+    mem_free(nodes);
+
+    return rc;
 }
 
 // 0x4908A0
@@ -221,54 +306,29 @@ int queue_add(int delay, Object* obj, void* data, int eventType)
     newQueueListNode->type = eventType;
     newQueueListNode->owner = obj;
     newQueueListNode->data = data;
+    newQueueListNode->seq = queue_next_seq++;
+    newQueueListNode->clearSlot = NULL;
 
-    if (obj != NULL) {
-        obj->flags |= OBJECT_USED;
+    if (queue_insert(newQueueListNode) == -1) {
+        mem_free(newQueueListNode);
+        return -1;
     }
 
-    QueueListNode** v3 = &queue;
-
-    if (queue != NULL) {
-        QueueListNode* v4;
-
-        do {
-            v4 = *v3;
-            if (v2 < v4->time) {
-                break;
-            }
-            v3 = &(v4->next);
-        } while (v4->next != NULL);
+    if (obj != NULL) {
+        obj->flags |= OBJECT_USED;
     }
 
-    newQueueListNode->next = *v3;
-    *v3 = newQueueListNode;
-
     return 0;
 }
 
 // 0x490908
 int queue_remove(Object* owner)
 {
-    QueueListNode* queueListNode = queue;
-    QueueListNode** queueListNodePtr = &queue;
-
-    while (queueListNode) {
-        if (queueListNode->owner == owner) {
-            QueueListNode* temp = queueListNode;
-
-            queueListNode = queueListNode->next;
-            *queueListNodePtr = queueListNode;
-
-            EventTypeDescription* eventTypeDescription = &(q_func[temp->type]);
-            if (eventTypeDescription->freeProc != NULL) {
-                eventTypeDescription->freeProc(temp->data);
-            }
-
-            mem_free(temp);
-        } else {
-            queueListNodePtr = &(queueListNode->next);
-            queueListNode = queueListNode->next;
-        }
+    QueueOwnerEntry* entry;
+    while ((entry = queue_owner_find(owner)) != NULL) {
+        QueueListNode* queueListNode = entry->head;
+        queue_unlink(queueListNode);
+        queue_free_node(queueListNode);
     }
 
     return 0;
@@ -277,26 +337,19 @@ int queue_remove(Object* owner)
 // 0x490960
 int queue_remove_this(Object* owner, int eventType)
 {
-    QueueListNode* queueListNode = queue;
-    QueueListNode** queueListNodePtr = &queue;
-
-    while (queueListNode) {
-        if (queueListNode->owner == owner && queueListNode->type == eventType) {
-            QueueListNode* temp = queueListNode;
-
-            queueListNode = queueListNode->next;
-            *queueListNodePtr = queueListNode;
-
-            EventTypeDescription* eventTypeDescription = &(q_func[temp->type]);
-            if (eventTypeDescription->freeProc != NULL) {
-                eventTypeDescription->freeProc(temp->data);
-            }
+    QueueOwnerEntry* entry = queue_owner_find(owner);
+    if (entry == NULL) {
+        return 0;
+    }
 
-            mem_free(temp);
-        } else {
-            queueListNodePtr = &(queueListNode->next);
-            queueListNode = queueListNode->next;
+    QueueListNode* queueListNode = entry->head;
+    while (queueListNode != NULL) {
+        QueueListNode* next = queueListNode->ownerNext;
+        if (queueListNode->type == eventType) {
+            queue_unlink(queueListNode);
+            queue_free_node(queueListNode);
         }
+        queueListNode = next;
     }
 
     return 0;
@@ -307,13 +360,18 @@ int queue_remove_this(Object* owner, int eventType)
 // 0x4909BC
 bool queue_find(Object* owner, int eventType)
 {
-    QueueListNode* queueListEvent = queue;
+    QueueOwnerEntry* entry = queue_owner_find(owner);
+    if (entry == NULL) {
+        return false;
+    }
+
+    QueueListNode* queueListEvent = entry->head;
     while (queueListEvent != NULL) {
-        if (owner == queueListEvent->owner && eventType == queueListEvent->type) {
+        if (eventType == queueListEvent->type) {
             return true;
         }
 
-        queueListEvent = queueListEvent->next;
+        queueListEvent = queueListEvent->ownerNext;
     }
 
     return false;
@@ -325,22 +383,18 @@ int queue_process()
     int time = game_time();
     int v1 = 0;
 
-    while (queue != NULL) {
-        QueueListNode* queueListNode = queue;
+    while (queue_heap_length != 0) {
+        QueueListNode* queueListNode = queue_heap[0];
         if (time < queueListNode->time || v1 != 0) {
             break;
         }
 
-        queue = queueListNode->next;
+        queue_unlink(queueListNode);
 
         EventTypeDescription* eventTypeDescription = &(q_func[queueListNode->type]);
         v1 = eventTypeDescription->handlerProc(queueListNode->owner, queueListNode->data);
 
-        if (eventTypeDescription->freeProc != NULL) {
-            eventTypeDescription->freeProc(queueListNode->data);
-        }
-
-        mem_free(queueListNode);
+        queue_free_node(queueListNode);
     }
 
     return v1;
@@ -349,50 +403,134 @@ int queue_process()
 // 0x490A5C
 void queue_clear()
 {
-    QueueListNode* queueListNode = queue;
-    while (queueListNode != NULL) {
-        QueueListNode* next = queueListNode->next;
-
-        EventTypeDescription* eventTypeDescription = &(q_func[queueListNode->type]);
-        if (eventTypeDescription->freeProc != NULL) {
-            eventTypeDescription->freeProc(queueListNode->data);
-        }
+    for (int index = 0; index < queue_heap_length; index++) {
+        queue_free_node(queue_heap[index]);
+    }
 
-        mem_free(queueListNode);
+    queue_heap_length = 0;
 
-        queueListNode = next;
+    for (int index = 0; index < queue_owner_capacity; index++) {
+        queue_owner_index[index].owner = NULL;
+        queue_owner_index[index].head = NULL;
     }
+    queue_owner_length = 0;
 
-    queue = NULL;
+    for (int index = 0; index < EVENT_TYPE_COUNT; index++) {
+        queue_type_lists[index] = NULL;
+    }
 }
 
 // 0x490AA4
 void queue_clear_type(int eventType, QueueEventHandler* fn)
 {
-    QueueListNode** ptr = &queue;
-    QueueListNode* curr = *ptr;
-
-    while (curr != NULL) {
-        if (eventType == curr->type) {
-            QueueListNode* tmp = curr;
-
-            *ptr = curr->next;
-            curr = *ptr;
-
-            if (fn != NULL && fn(tmp->owner, tmp->data) != 1) {
-                *ptr = tmp;
-                ptr = &(tmp->next);
-            } else {
-                EventTypeDescription* eventTypeDescription = &(q_func[tmp->type]);
-                if (eventTypeDescription->freeProc != NULL) {
-                    eventTypeDescription->freeProc(tmp->data);
+    if (fn == NULL) {
+        while (queue_type_lists[eventType] != NULL) {
+            QueueListNode* queueListNode = queue_type_lists[eventType];
+            queue_unlink(queueListNode);
+            queue_free_node(queueListNode);
+        }
+        return;
+    }
+
+    int length = 0;
+    for (QueueListNode* node = queue_type_lists[eventType]; node != NULL; node = node->typeNext) {
+        length++;
+    }
+
+    if (length == 0) {
+        return;
+    }
+
+    QueueListNode** nodes = (QueueListNode**)mem_malloc(sizeof(*nodes) * length);
+    if (nodes == NULL) {
+        debug_printf("\nError: queue_clear_type: couldn't allocate snapshot of %d events, walking in place", length);
+        queue_clear_type_in_place(eventType, fn);
+        return;
+    }
+
+    int index = 0;
+    for (QueueListNode* node = queue_type_lists[eventType]; node != NULL; node = node->typeNext) {
+        nodes[index++] = node;
+    }
+
+    qsort(nodes, length, sizeof(*nodes), queue_save_compare);
+
+    // [fn] can add and remove events. Every snapshotted event remembers its
+    // slot so that unlinking or freeing it empties the slot, which makes
+    // events removed by [fn] to be skipped. Events added by [fn] are not in
+    // the snapshot and stay queued.
+    for (index = 0; index < length; index++) {
+        QueueListNode* node = nodes[index];
+
+        // Event is already in the snapshot of an outer call (when [fn]
+        // clears the same type recursively), this call takes it over.
+        if (node->clearSlot != NULL) {
+            *node->clearSlot = NULL;
+        }
+
+        node->clearSlot = &(nodes[index]);
+    }
+
+    for (index = 0; index < length; index++) {
+        QueueListNode* curr = nodes[index];
+        if (curr == NULL) {
+            continue;
+        }
+
+        queue_unlink(curr);
+
+        if (fn(curr->owner, curr->data) != 1) {
+            if (queue_insert(curr) == -1) {
+                queue_free_node(curr);
+            }
+        } else {
+            queue_free_node(curr);
+        }
+    }
+
+    mem_free(nodes);
+}
+
+// Same as [queue_clear_type] but without a snapshot, used when it cannot be
+// allocated. [fn] can add and remove events, so instead of walking type list
+// pick events one by one in processing order, starting after last visited.
+// Quadratic in number of events of [eventType].
+static void queue_clear_type_in_place(int eventType, QueueEventHandler* fn)
+{
+    int lastTime = 0;
+    unsigned int lastSeq = 0;
+    bool first = true;
+
+    for (;;) {
+        QueueListNode* curr = NULL;
+        QueueListNode* node = queue_type_lists[eventType];
+        while (node != NULL) {
+            if (first
+                || node->time > lastTime
+                || (node->time == lastTime && node->seq > lastSeq)) {
+                if (curr == NULL || queue_node_before(node, curr)) {
+                    curr = node;
                 }
+            }
+            node = node->typeNext;
+        }
+
+        if (curr == NULL) {
+            break;
+        }
+
+        first = false;
+        lastTime = curr->time;
+        lastSeq = curr->seq;
 
-                mem_free(tmp);
+        queue_unlink(curr);
+
+        if (fn(curr->owner, curr->data) != 1) {
+            if (queue_insert(curr) == -1) {
+                queue_free_node(curr);
             }
         } else {
-            ptr = &(curr->next);
-            curr = *ptr;
+            queue_free_node(curr);
         }
     }
 }
@@ -402,11 +540,289 @@ void queue_clear_type(int eventType, QueueEventHandler* fn)
 // 0x490B1C
 int queue_next_time()
 {
-    if (queue == NULL) {
+    if (queue_heap_length == 0) {
         return 0;
     }
 
-    return queue->time;
+    return queue_heap[0]->time;
+}
+
+// Adds [node] to [queue_heap], its owner chain and type list.
+static int queue_insert(QueueListNode* node)
+{
+    if (queue_heap_length == queue_heap_capacity) {
+        if (queue_heap_grow() == -1) {
+            return -1;
+        }
+    }
+
+    // Keep load factor under 3/4.
+    if ((queue_owner_length + 1) * 4 > queue_owner_capacity * 3) {
+        if (queue_owner_grow() == -1) {
+            return -1;
+        }
+    }
+
+    QueueOwnerEntry* entry = queue_owner_find(node->owner);
+    if (entry == NULL) {
+        unsigned int mask = queue_owner_capacity - 1;
+        unsigned int pos = queue_owner_hash(node->owner) & mask;
+        while (queue_owner_index[pos].head != NULL) {
+            pos = (pos + 1) & mask;
+        }
+
+        entry = &(queue_owner_index[pos]);
+        entry->owner = node->owner;
+        entry->head = NULL;
+        queue_owner_length++;
+    }
+
+    node->ownerPrev = NULL;
+    node->ownerNext = entry->head;
+    if (entry->head != NULL) {
+        entry->head->ownerPrev = node;
+    }
+    entry->head = node;
+
+    node->typePrev = NULL;
+    node->typeNext = queue_type_lists[node->type];
+    if (queue_type_lists[node->type] != NULL) {
+        queue_type_lists[node->type]->typePrev = node;
+    }
+    queue_type_lists[node->type] = node;
+
+    node->heapIndex = queue_heap_length;
+    queue_heap[queue_heap_length] = node;
+    queue_heap_length++;
+    queue_heap_sift_up(node->heapIndex);
+
+    return 0;
+}
+
+// Removes [node] from [queue_heap], its owner chain and type list without
+// freeing it.
+static void queue_unlink(QueueListNode* node)
+{
+    if (node->clearSlot != NULL) {
+        *node->clearSlot = NULL;
+        node->clearSlot = NULL;
+    }
+
+    int index = node->heapIndex;
+    queue_heap_length--;
+    if (index != queue_heap_length) {
+        QueueListNode* moved = queue_heap[queue_heap_length];
+        queue_heap[index] = moved;
+        moved->heapIndex = index;
+        queue_heap_sift_up(index);
+        queue_heap_sift_down(moved->heapIndex);
+    }
+
+    if (node->typePrev != NULL) {
+        node->typePrev->typeNext = node->typeNext;
+    } else {
+        queue_type_lists[node->type] = node->typeNext;
+    }
+
+    if (node->typeNext != NULL) {
+        node->typeNext->typePrev = node->typePrev;
+    }
+
+    if (node->ownerNext != NULL) {
+        node->ownerNext->ownerPrev = node->ownerPrev;
+    }
+
+    if (node->ownerPrev != NULL) {
+        node->ownerPrev->ownerNext = node->ownerNext;
+        return;
+    }
+
+    QueueOwnerEntry* entry = queue_owner_find(node->owner);
+    entry->head = node->ownerNext;
+    if (entry->head != NULL) {
+        return;
+    }
+
+    // Owner has no more events, remove its entry with backward shift
+    // deletion so that probe sequences stay intact.
+    unsigned int mask = queue_owner_capacity - 1;
+    unsigned int hole = entry - queue_owner_index;
+    unsigned int pos = (hole + 1) & mask;
+    while (queue_owner_index[pos].head != NULL) {
+        unsigned int home = queue_owner_hash(queue_owner_index[pos].owner) & mask;
+        if (((pos - home) & mask) >= ((pos - hole) & mask)) {
+            queue_owner_index[hole] = queue_owner_index[pos];
+            queue_owner_index[pos].owner = NULL;
+            queue_owner_index[pos].head = NULL;
+            hole = pos;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    queue_owner_length--;
+}
+
+// Frees [node] and its data.
+static void queue_free_node(QueueListNode* node)
+{
+    if (node->clearSlot != NULL) {
+        *node->clearSlot = NULL;
+    }
+
+    EventTypeDescription* eventTypeDescription = &(q_func[node->type]);
+    if (eventTypeDescription->freeProc != NULL) {
+        eventTypeDescription->freeProc(node->data);
+    }
+
+    mem_free(node);
+}
+
+// Returns `true` if [a] should be processed before [b].
+static bool queue_node_before(QueueListNode* a, QueueListNode* b)
+{
+    if (a->time != b->time) {
+        return a->time < b->time;
+    }
+
+    return a->seq < b->seq;
+}
+
+static void queue_heap_sift_up(int index)
+{
+    QueueListNode* node = queue_heap[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!queue_node_before(node, queue_heap[parent])) {
+            break;
+        }
+
+        queue_heap[index] = queue_heap[parent];
+        queue_heap[index]->heapIndex = index;
+        index = parent;
+    }
+
+    queue_heap[index] = node;
+    node->heapIndex = index;
+}
+
+static void queue_heap_sift_down(int index)
+{
+    QueueListNode* node = queue_heap[index];
+    for (;;) {
+        int child = index * 2 + 1;
+        if (child >= queue_heap_length) {
+            break;
+        }
+
+        if (child + 1 < queue_heap_length && queue_node_before(queue_heap[child + 1], queue_heap[child])) {
+            child++;
+        }
+
+        if (!queue_node_before(queue_heap[child], node)) {
+            break;
+        }
+
+        queue_heap[index] = queue_heap[child];
+        queue_heap[index]->heapIndex = index;
+        index = child;
+    }
+
+    queue_heap[index] = node;
+    node->heapIndex = index;
+}
+
+// Doubles [queue_heap] capacity.
+static int queue_heap_grow()
+{
+    int capacity = queue_heap_capacity != 0 ? queue_heap_capacity * 2 : QUEUE_HEAP_INITIAL_CAPACITY;
+    QueueListNode** heap = (QueueListNode**)mem_realloc(queue_heap, sizeof(*heap) * capacity);
+    if (heap == NULL) {
+        return -1;
+    }
+
+    queue_heap = heap;
+    queue_heap_capacity = capacity;
+
+    return 0;
+}
+
+static unsigned int queue_owner_hash(Object* owner)
+{
+    unsigned int hash = (unsigned int)(uintptr_t)owner;
+    hash ^= hash >> 16;
+    hash *= 0x45D9F3B;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+// Returns [queue_owner_index] entry for [owner], or NULL if it has no events.
+static QueueOwnerEntry* queue_owner_find(Object* owner)
+{
+    if (queue_owner_length == 0) {
+        return NULL;
+    }
+
+    unsigned int mask = queue_owner_capacity - 1;
+    unsigned int pos = queue_owner_hash(owner) & mask;
+    while (queue_owner_index[pos].head != NULL) {
+        if (queue_owner_index[pos].owner == owner) {
+            return &(queue_owner_index[pos]);
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    return NULL;
+}
+
+// Doubles [queue_owner_index] capacity and rehashes existing entries.
+static int queue_owner_grow()
+{
+    int capacity = queue_owner_capacity != 0 ? queue_owner_capacity * 2 : QUEUE_OWNER_INDEX_INITIAL_CAPACITY;
+    QueueOwnerEntry* entries = (QueueOwnerEntry*)mem_malloc(sizeof(*entries) * capacity);
+    if (entries == NULL) {
+        return -1;
+    }
+
+    for (int index = 0; index < capacity; index++) {
+        entries[index].owner = NULL;
+        entries[index].head = NULL;
+    }
+
+    unsigned int mask = capacity - 1;
+    for (int index = 0; index < queue_owner_capacity; index++) {
+        if (queue_owner_index[index].head != NULL) {
+            unsigned int pos = queue_owner_hash(queue_owner_index[index].owner) & mask;
+            while (entries[pos].head != NULL) {
+                pos = (pos + 1) & mask;
+            }
+            entries[pos] = queue_owner_index[index];
+        }
+    }
+
+    if (queue_owner_index != NULL) {
+        mem_free(queue_owner_index);
+    }
+
+    queue_owner_index = entries;
+    queue_owner_capacity = capacity;
+
+    return 0;
+}
+
+static int queue_save_compare(const void* a1, const void* a2)
+{
+    QueueListNode* v1 = *(QueueListNode**)a1;
+    QueueListNode* v2 = *(QueueListNode**)a2;
+
+    if (queue_node_before(v1, v2)) {
+        return -1;
+    }
+
+    if (queue_node_before(v2, v1)) {
+        return 1;
+    }
+
+    return 0;
 }
 
 // 0x490B30
@@ -1,5 +1,6 @@
 #include "game/scripts.h"
 
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -15,6 +16,7 @@
 #include "game/gdialog.h"
 #include "game/gmouse.h"
 #include "game/gmovie.h"
+#include "game/map_defs.h"
 #include "game/object.h"
 #include "game/protinst.h"
 #include "game/proto.h"
@@ -57,6 +59,21 @@ typedef struct ScriptList {
 
 static_assert(sizeof(ScriptList) == 0x10, "wrong size");
 
+#define SCRIPT_INDEX_INITIAL_CAPACITY 256
+
+// Entry of [scr_index]. Unused entries have `sid` set to -1.
+typedef struct ScriptIndexEntry {
+    int sid;
+    Script* script;
+} ScriptIndexEntry;
+
+// Side of the square cells (in hexes) spatial scripts are bucketed by, see
+// [scr_spatial_cell_start].
+#define SCRIPT_SPATIAL_CELL_SIZE 8
+#define SCRIPT_SPATIAL_CELL_COLUMNS ((HEX_GRID_WIDTH + SCRIPT_SPATIAL_CELL_SIZE - 1) / SCRIPT_SPATIAL_CELL_SIZE)
+#define SCRIPT_SPATIAL_CELL_ROWS ((HEX_GRID_HEIGHT + SCRIPT_SPATIAL_CELL_SIZE - 1) / SCRIPT_SPATIAL_CELL_SIZE)
+#define SCRIPT_SPATIAL_CELL_COUNT (ELEVATION_COUNT * SCRIPT_SPATIAL_CELL_COLUMNS * SCRIPT_SPATIAL_CELL_ROWS)
+
 typedef struct ScriptState {
     unsigned int requests;
     STRUCT_664980 combatState1;
@@ -79,12 +96,24 @@ static void script_chk_critters();
 static void script_chk_timed_events();
 static int scr_build_lookup_table(Script* scr);
 static int scr_index_to_name(int scriptIndex, char* name);
+static int scr_list_load();
+static void scr_list_free();
 static int scr_header_load();
 static int scr_write_ScriptSubNode(Script* scr, DB_FILE* stream);
 static int scr_write_ScriptNode(ScriptListExtent* a1, DB_FILE* stream);
 static int scr_read_ScriptSubNode(Script* scr, DB_FILE* stream);
 static int scr_read_ScriptNode(ScriptListExtent* a1, DB_FILE* stream);
 static int scr_new_id(int scriptType);
+static unsigned int scr_index_hash(int sid);
+static ScriptIndexEntry* scr_index_find(int sid);
+static int scr_index_grow();
+static int scr_index_set(int sid, Script* script);
+static void scr_index_remove(int sid, Script* script);
+static void scr_index_clear();
+static void scr_index_free();
+static int scr_spatial_cell(int tile, int elevation);
+static int scr_spatial_index_rebuild();
+static void scr_spatial_index_free();
 static void scrExecMapProcScripts(int a1);
 
 // Number of lines in scripts.lst
@@ -110,6 +139,63 @@ static ScriptList scriptlists[SCRIPT_TYPE_COUNT];
 // 0x5078B0
 static char script_path_base[] = "scripts\\";
 
+// Open-addressing table (linear probing) mapping every sid in [scriptlists]
+// to its slot. It is kept in sync whenever scripts are added, removed,
+// relocated or renamed, so lookups which find nothing are authoritative.
+static ScriptIndexEntry* scr_index = NULL;
+
+// Number of entries in [scr_index], always a power of two.
+static int scr_index_capacity = 0;
+
+// Number of used entries in [scr_index].
+static int scr_index_length = 0;
+
+// Number of [scr_ptr] calls since last [scr_index_stats].
+static int scr_index_lookups = 0;
+
+// Spatial scripts bucketed by cells of the hex grid, so [scr_chk_spatials_in]
+// only looks at scripts whose area may cover the tile. Cell `n` owns sids in
+// [scr_spatial_sids] from `scr_spatial_cell_start[n]` up to (but not
+// including) `scr_spatial_cell_start[n + 1]`, in script list order.
+static int scr_spatial_cell_start[SCRIPT_SPATIAL_CELL_COUNT + 1];
+
+static int* scr_spatial_sids = NULL;
+
+// Number of entries [scr_spatial_sids] can hold.
+static int scr_spatial_sids_capacity = 0;
+
+// Set whenever spatial scripts are added, removed, reordered or renamed. The
+// index is rebuilt on next [scr_chk_spatials_in]. Spatial location and radius
+// are only assigned right after [scr_new] or on load, so this also covers
+// them.
+static bool scr_spatial_dirty = true;
+
+// Number of [scr_chk_spatials_in] calls which consulted the spatial index,
+// number of scripts they visited and number of index rebuilds since last
+// [scr_spatial_stats].
+static int scr_spatial_checks = 0;
+static int scr_spatial_visited = 0;
+static int scr_spatial_rebuilds = 0;
+
+// Script names from scripts.lst (without extension), see [scr_list_load].
+// Offsets in [scr_list_data] by line, or -1 for lines without name.
+static int* scr_list_offsets = NULL;
+
+// Number of lines in [scr_list_offsets].
+static int scr_list_length = 0;
+
+static char* scr_list_data = NULL;
+
+static bool scr_list_loaded = false;
+
+// Value of [db_generation] scripts.lst was read at.
+static unsigned int scr_list_generation = 0;
+
+// Number of times [scr_list_load] read scripts.lst and time it spent reading
+// (in ms) since last [scr_index_stats].
+static int scr_list_reads = 0;
+static unsigned int scr_list_read_time = 0;
+
 // 0x5078B4
 static bool script_engine_running = false;
 
@@ -182,6 +268,16 @@ MessageList script_dialog_msgs[SCRIPT_DIALOG_MESSAGE_LIST_CAPACITY];
 // 0x664F14
 MessageList script_message_file;
 
+// Layout of [Script] fields following type specific data in map and save
+// files, see [scr_read_ScriptSubNode]. Program pointer is saved but never
+// restored.
+static const db_field scr_fields[] = {
+    { 4, 2, offsetof(Script, scr_flags) },
+    { 4, 1, DB_FIELD_SKIP },
+    { 4, 6, offsetof(Script, scr_oid) },
+    { 4, 5, offsetof(Script, actionBeingUsed) },
+};
+
 // TODO: Make unsigned.
 //
 // Returns game time in ticks (1/10 second).
@@ -836,8 +932,9 @@ int scripts_check_state()
                         obj_set_frame(elevatorDoors, 0, NULL);
                         obj_move_to_tile(elevatorDoors, elevatorDoors->tile, elevatorDoors->elevation, NULL);
                         elevatorDoors->flags &= ~OBJECT_OPEN_DOOR;
+                        obj_blocking_changed(elevatorDoors);
                         elevatorDoors->data.scenery.door.openFlags &= ~0x01;
-                        obj_rebuild_all_light();
+                        obj_light_tile_changed(elevatorDoors->tile, elevatorDoors->elevation, NULL);
                     } else {
                         debug_printf("\nWarning: Elevator: Couldn't find old elevator doors!");
                     }
@@ -858,8 +955,9 @@ int scripts_check_state()
                     obj_set_frame(elevatorDoors, 0, NULL);
                     obj_move_to_tile(elevatorDoors, elevatorDoors->tile, elevatorDoors->elevation, NULL);
                     elevatorDoors->flags &= ~OBJECT_OPEN_DOOR;
+                    obj_blocking_changed(elevatorDoors);
                     elevatorDoors->data.scenery.door.openFlags &= ~0x01;
-                    obj_rebuild_all_light();
+                    obj_light_tile_changed(elevatorDoors->tile, elevatorDoors->elevation, NULL);
                 } else {
                     debug_printf("\nWarning: Elevator: Couldn't find old elevator doors!");
                 }
@@ -941,8 +1039,9 @@ int scripts_check_state_in_combat()
                         obj_set_frame(elevatorDoors, 0, NULL);
                         obj_move_to_tile(elevatorDoors, elevatorDoors->tile, elevatorDoors->elevation, NULL);
                         elevatorDoors->flags &= ~OBJECT_OPEN_DOOR;
+                        obj_blocking_changed(elevatorDoors);
                         elevatorDoors->data.scenery.door.openFlags &= ~0x01;
-                        obj_rebuild_all_light();
+                        obj_light_tile_changed(elevatorDoors->tile, elevatorDoors->elevation, NULL);
                     } else {
                         debug_printf("\nWarning: Elevator: Couldn't find old elevator doors!");
                     }
@@ -1226,13 +1325,6 @@ int scr_find_str_run_info(int scr_script_idx, int* run_info_flags, int sid)
 // 0x492FC4
 static int scr_index_to_name(int scr_script_idx, char* name)
 {
-    int rc = -1;
-    char path[MAX_PATH];
-    DB_FILE* stream;
-    int idx;
-    char string[MAX_PATH];
-    char* sep;
-
     if (scr_script_idx < 0) {
         return -1;
     }
@@ -1241,6 +1333,42 @@ static int scr_index_to_name(int scr_script_idx, char* name)
         return -1;
     }
 
+    if (!scr_list_loaded || scr_list_generation != db_generation()) {
+        if (scr_list_load() == -1) {
+            return -1;
+        }
+    }
+
+    if (scr_script_idx >= scr_list_length) {
+        return -1;
+    }
+
+    int offset = scr_list_offsets[scr_script_idx];
+    if (offset == -1) {
+        return -1;
+    }
+
+    sprintf(name, "%s.%s", scr_list_data + offset, "int");
+
+    return 0;
+}
+
+// Reads scripts.lst into [scr_list_offsets]. Every line is reduced to the
+// script name the same way [scr_index_to_name] always did.
+static int scr_list_load()
+{
+    char path[MAX_PATH];
+    DB_FILE* stream;
+    char string[MAX_PATH];
+    int offsetsCapacity;
+    int dataLength;
+    int dataCapacity;
+    unsigned int start;
+
+    start = get_time();
+
+    scr_list_free();
+
     script_make_path(path);
     strcat(path, "scripts.lst");
 
@@ -1249,24 +1377,80 @@ static int scr_index_to_name(int scr_script_idx, char* name)
         return -1;
     }
 
-    for (idx = 0; idx <= scr_script_idx; idx++) {
-        if (db_fgets(string, sizeof(string), stream) == NULL) {
-            break;
+    offsetsCapacity = 0;
+    dataLength = 0;
+    dataCapacity = 0;
+
+    while (db_fgets(string, sizeof(string), stream) != NULL) {
+        if (scr_list_length == offsetsCapacity) {
+            int capacity = offsetsCapacity != 0 ? offsetsCapacity * 2 : 1024;
+            int* offsets = (int*)mem_realloc(scr_list_offsets, sizeof(*offsets) * capacity);
+            if (offsets == NULL) {
+                db_fclose(stream);
+                scr_list_free();
+                return -1;
+            }
+
+            scr_list_offsets = offsets;
+            offsetsCapacity = capacity;
         }
-    }
 
-    if (idx - 1 == scr_script_idx) {
-        sep = strchr(string, '.');
-        if (sep != NULL) {
-            *sep = '\0';
-            sprintf(name, "%s.%s", string, "int");
-            rc = 0;
+        char* sep = strchr(string, '.');
+        if (sep == NULL) {
+            scr_list_offsets[scr_list_length++] = -1;
+            continue;
         }
+
+        *sep = '\0';
+
+        int size = strlen(string) + 1;
+        if (dataLength + size > dataCapacity) {
+            int capacity = dataCapacity != 0 ? dataCapacity * 2 : 16384;
+            while (dataLength + size > capacity) {
+                capacity *= 2;
+            }
+
+            char* data = (char*)mem_realloc(scr_list_data, capacity);
+            if (data == NULL) {
+                db_fclose(stream);
+                scr_list_free();
+                return -1;
+            }
+
+            scr_list_data = data;
+            dataCapacity = capacity;
+        }
+
+        memcpy(scr_list_data + dataLength, string, size);
+        scr_list_offsets[scr_list_length++] = dataLength;
+        dataLength += size;
     }
 
     db_fclose(stream);
 
-    return rc;
+    scr_list_loaded = true;
+    scr_list_generation = db_generation();
+
+    scr_list_reads++;
+    scr_list_read_time += elapsed_tocks(get_time(), start);
+
+    return 0;
+}
+
+static void scr_list_free()
+{
+    if (scr_list_offsets != NULL) {
+        mem_free(scr_list_offsets);
+        scr_list_offsets = NULL;
+    }
+
+    if (scr_list_data != NULL) {
+        mem_free(scr_list_data);
+        scr_list_data = NULL;
+    }
+
+    scr_list_length = 0;
+    scr_list_loaded = false;
 }
 
 // 0x492FBC
@@ -1440,6 +1624,9 @@ int scr_exit()
 
     scr_remove_all();
     scr_remove_all_force();
+    scr_index_free();
+    scr_spatial_index_free();
+    scr_list_free();
     interpretClose();
     clearPrograms();
 
@@ -1607,6 +1794,8 @@ static int scr_header_load()
 
     db_fclose(stream);
 
+    scr_list_load();
+
     for (int scriptType = 0; scriptType < SCRIPT_TYPE_COUNT; scriptType++) {
         ScriptList* scriptList = &(scriptlists[scriptType]);
         scriptList->head = NULL;
@@ -1615,6 +1804,8 @@ static int scr_header_load()
         scriptList->nextScriptId = 0;
     }
 
+    scr_index_clear();
+
     return 0;
 }
 
@@ -1725,6 +1916,9 @@ int scr_save(DB_FILE* stream)
                         memcpy(script, &(lastScriptExtent->scripts[backwardsIndex]), sizeof(Script));
                         memcpy(&(lastScriptExtent->scripts[backwardsIndex]), &temp, sizeof(Script));
 
+                        scr_index_set(script->scr_id, script);
+                        scr_index_set(temp.scr_id, &(lastScriptExtent->scripts[backwardsIndex]));
+
                         scriptCount++;
                     }
                 }
@@ -1772,8 +1966,6 @@ int scr_save(DB_FILE* stream)
 // 0x493BB8
 static int scr_read_ScriptSubNode(Script* scr, DB_FILE* stream)
 {
-    int prg;
-
     if (db_freadInt(stream, &(scr->scr_id)) == -1) return -1;
     if (db_freadInt(stream, &(scr->scr_next)) == -1) return -1;
 
@@ -1787,20 +1979,7 @@ static int scr_read_ScriptSubNode(Script* scr, DB_FILE* stream)
         break;
     }
 
-    if (db_freadInt(stream, &(scr->scr_flags)) == -1) return -1;
-    if (db_freadInt(stream, &(scr->scr_script_idx)) == -1) return -1;
-    if (db_freadInt(stream, &(prg)) == -1) return -1;
-    if (db_freadInt(stream, &(scr->scr_oid)) == -1) return -1;
-    if (db_freadInt(stream, &(scr->scr_local_var_offset)) == -1) return -1;
-    if (db_freadInt(stream, &(scr->scr_num_local_vars)) == -1) return -1;
-    if (db_freadInt(stream, &(scr->field_28)) == -1) return -1;
-    if (db_freadInt(stream, &(scr->action)) == -1) return -1;
-    if (db_freadInt(stream, &(scr->fixedParam)) == -1) return -1;
-    if (db_freadInt(stream, &(scr->actionBeingUsed)) == -1) return -1;
-    if (db_freadInt(stream, &(scr->scriptOverrides)) == -1) return -1;
-    if (db_freadInt(stream, &(scr->field_48)) == -1) return -1;
-    if (db_freadInt(stream, &(scr->howMuch)) == -1) return -1;
-    if (db_freadInt(stream, &(scr->run_info_flags)) == -1) return -1;
+    if (db_freadRecord(stream, scr, scr_fields, sizeof(scr_fields) / sizeof(scr_fields[0])) == -1) return -1;
 
     scr->program = NULL;
     scr->owner = NULL;
@@ -1843,6 +2022,8 @@ static int scr_read_ScriptNode(ScriptListExtent* scriptExtent, DB_FILE* stream)
 // 0x493DF4
 int scr_load(DB_FILE* stream)
 {
+    scr_index_clear();
+
     for (int index = 0; index < SCRIPT_TYPE_COUNT; index++) {
         ScriptList* scriptList = &(scriptlists[index]);
 
@@ -1876,6 +2057,10 @@ int scr_load(DB_FILE* stream)
                 script->target = NULL;
                 script->program = NULL;
                 script->scr_flags &= ~SCRIPT_FLAG_0x01;
+
+                if (scr_index_set(script->scr_id, script) == -1) {
+                    return -1;
+                }
             }
 
             extent->next = NULL;
@@ -1898,6 +2083,10 @@ int scr_load(DB_FILE* stream)
                     script->target = NULL;
                     script->program = NULL;
                     script->scr_flags &= ~SCRIPT_FLAG_0x01;
+
+                    if (scr_index_set(script->scr_id, script) == -1) {
+                        return -1;
+                    }
                 }
 
                 prevExtent->next = extent;
@@ -1931,21 +2120,16 @@ int scr_ptr(int sid, Script** scriptPtr)
         return -1;
     }
 
-    ScriptList* scriptList = &(scriptlists[SID_TYPE(sid)]);
-    ScriptListExtent* scriptListExtent = scriptList->head;
+    scr_index_lookups++;
 
-    while (scriptListExtent != NULL) {
-        for (int index = 0; index < scriptListExtent->length; index++) {
-            Script* script = &(scriptListExtent->scripts[index]);
-            if (script->scr_id == sid) {
-                *scriptPtr = script;
-                return 0;
-            }
-        }
-        scriptListExtent = scriptListExtent->next;
+    ScriptIndexEntry* entry = scr_index_find(sid);
+    if (entry == NULL) {
+        return -1;
     }
 
-    return -1;
+    *scriptPtr = entry->script;
+
+    return 0;
 }
 
 // 0x494080
@@ -1965,6 +2149,249 @@ static int scr_new_id(int scriptType)
     return scriptId;
 }
 
+static unsigned int scr_index_hash(int sid)
+{
+    // Script type lives in the high byte, mix it into the low bits.
+    unsigned int hash = (unsigned int)sid;
+    hash ^= hash >> 16;
+    hash *= 0x45D9F3B;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+// Returns [scr_index] entry for [sid], or NULL if there is no such script.
+static ScriptIndexEntry* scr_index_find(int sid)
+{
+    if (scr_index_length == 0) {
+        return NULL;
+    }
+
+    unsigned int mask = scr_index_capacity - 1;
+    unsigned int pos = scr_index_hash(sid) & mask;
+    while (scr_index[pos].sid != -1) {
+        if (scr_index[pos].sid == sid) {
+            return &(scr_index[pos]);
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    return NULL;
+}
+
+// Doubles [scr_index] capacity and rehashes existing entries.
+static int scr_index_grow()
+{
+    int capacity = scr_index_capacity != 0 ? scr_index_capacity * 2 : SCRIPT_INDEX_INITIAL_CAPACITY;
+    ScriptIndexEntry* entries = (ScriptIndexEntry*)mem_malloc(sizeof(*entries) * capacity);
+    if (entries == NULL) {
+        debug_printf("\nError: scr_index_grow: out of memory!");
+        return -1;
+    }
+
+    for (int index = 0; index < capacity; index++) {
+        entries[index].sid = -1;
+        entries[index].script = NULL;
+    }
+
+    ScriptIndexEntry* oldEntries = scr_index;
+    int oldCapacity = scr_index_capacity;
+
+    scr_index = entries;
+    scr_index_capacity = capacity;
+    scr_index_length = 0;
+
+    for (int index = 0; index < oldCapacity; index++) {
+        if (oldEntries[index].sid != -1) {
+            scr_index_set(oldEntries[index].sid, oldEntries[index].script);
+        }
+    }
+
+    if (oldEntries != NULL) {
+        mem_free(oldEntries);
+    }
+
+    return 0;
+}
+
+// Points [sid] at [script], adding it to [scr_index] if needed.
+static int scr_index_set(int sid, Script* script)
+{
+    if (SID_TYPE(sid) == SCRIPT_TYPE_SPATIAL) {
+        scr_spatial_dirty = true;
+    }
+
+    if ((scr_index_length + 1) * 2 > scr_index_capacity) {
+        if (scr_index_grow() == -1) {
+            return -1;
+        }
+    }
+
+    unsigned int mask = scr_index_capacity - 1;
+    unsigned int pos = scr_index_hash(sid) & mask;
+    while (scr_index[pos].sid != -1) {
+        if (scr_index[pos].sid == sid) {
+            scr_index[pos].script = script;
+            return 0;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    scr_index[pos].sid = sid;
+    scr_index[pos].script = script;
+    scr_index_length++;
+
+    return 0;
+}
+
+// Removes [sid] from [scr_index] provided it still refers to [script].
+static void scr_index_remove(int sid, Script* script)
+{
+    if (SID_TYPE(sid) == SCRIPT_TYPE_SPATIAL) {
+        scr_spatial_dirty = true;
+    }
+
+    ScriptIndexEntry* entry = scr_index_find(sid);
+    if (entry == NULL || entry->script != script) {
+        return;
+    }
+
+    // Shift following entries of the same cluster back into the hole, so
+    // probing never needs tombstones.
+    unsigned int mask = scr_index_capacity - 1;
+    unsigned int hole = entry - scr_index;
+    unsigned int pos = (hole + 1) & mask;
+    while (scr_index[pos].sid != -1) {
+        unsigned int home = scr_index_hash(scr_index[pos].sid) & mask;
+        if (((pos - home) & mask) >= ((pos - hole) & mask)) {
+            scr_index[hole] = scr_index[pos];
+            hole = pos;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    scr_index[hole].sid = -1;
+    scr_index[hole].script = NULL;
+    scr_index_length--;
+}
+
+static void scr_index_clear()
+{
+    scr_spatial_dirty = true;
+
+    for (int index = 0; index < scr_index_capacity; index++) {
+        scr_index[index].sid = -1;
+        scr_index[index].script = NULL;
+    }
+
+    scr_index_length = 0;
+}
+
+static void scr_index_free()
+{
+    if (scr_index != NULL) {
+        mem_free(scr_index);
+        scr_index = NULL;
+    }
+
+    scr_index_capacity = 0;
+    scr_index_length = 0;
+}
+
+// Returns index of the [scr_spatial_cell_start] cell containing [tile] at
+// [elevation].
+static int scr_spatial_cell(int tile, int elevation)
+{
+    int column = (tile % HEX_GRID_WIDTH) / SCRIPT_SPATIAL_CELL_SIZE;
+    int row = (tile / HEX_GRID_WIDTH) / SCRIPT_SPATIAL_CELL_SIZE;
+    return (elevation * SCRIPT_SPATIAL_CELL_ROWS + row) * SCRIPT_SPATIAL_CELL_COLUMNS + column;
+}
+
+// Rebuilds [scr_spatial_sids] from spatial scripts list.
+//
+// Every step of [tile_dist] moves at most one hex column and one hex row, so
+// tiles within script's radius never leave the square of that radius around
+// script's tile. The script is added to every cell this square touches.
+static int scr_spatial_index_rebuild()
+{
+    int cellCounts[SCRIPT_SPATIAL_CELL_COUNT];
+    int pass;
+
+    memset(cellCounts, 0, sizeof(cellCounts));
+
+    // First pass counts scripts in every cell, second one places their sids.
+    for (pass = 0; pass < 2; pass++) {
+        ScriptListExtent* extent = scriptlists[SCRIPT_TYPE_SPATIAL].head;
+        while (extent != NULL) {
+            for (int index = 0; index < extent->length; index++) {
+                Script* script = &(extent->scripts[index]);
+                int tile = builtTileGetTile(script->sp.built_tile);
+                int elevation = builtTileGetElevation(script->sp.built_tile);
+                if (!hexGridTileIsValid(tile) || !elevationIsValid(elevation)) {
+                    continue;
+                }
+
+                int radius = script->sp.radius > 0 ? script->sp.radius : 0;
+                int column = tile % HEX_GRID_WIDTH;
+                int row = tile / HEX_GRID_WIDTH;
+                int minColumn = max(column - radius, 0);
+                int maxColumn = min(column + radius, HEX_GRID_WIDTH - 1);
+                int minRow = max(row - radius, 0);
+                int maxRow = min(row + radius, HEX_GRID_HEIGHT - 1);
+
+                for (int cellRow = minRow / SCRIPT_SPATIAL_CELL_SIZE; cellRow <= maxRow / SCRIPT_SPATIAL_CELL_SIZE; cellRow++) {
+                    for (int cellColumn = minColumn / SCRIPT_SPATIAL_CELL_SIZE; cellColumn <= maxColumn / SCRIPT_SPATIAL_CELL_SIZE; cellColumn++) {
+                        int cell = (elevation * SCRIPT_SPATIAL_CELL_ROWS + cellRow) * SCRIPT_SPATIAL_CELL_COLUMNS + cellColumn;
+                        if (pass == 0) {
+                            cellCounts[cell]++;
+                        } else {
+                            scr_spatial_sids[scr_spatial_cell_start[cell] + cellCounts[cell]] = script->scr_id;
+                            cellCounts[cell]++;
+                        }
+                    }
+                }
+            }
+            extent = extent->next;
+        }
+
+        if (pass == 0) {
+            int length = 0;
+            for (int cell = 0; cell < SCRIPT_SPATIAL_CELL_COUNT; cell++) {
+                scr_spatial_cell_start[cell] = length;
+                length += cellCounts[cell];
+                cellCounts[cell] = 0;
+            }
+            scr_spatial_cell_start[SCRIPT_SPATIAL_CELL_COUNT] = length;
+
+            if (length > scr_spatial_sids_capacity) {
+                int* sids = (int*)mem_realloc(scr_spatial_sids, sizeof(*sids) * length);
+                if (sids == NULL) {
+                    debug_printf("\nError: scr_spatial_index_rebuild: out of memory!");
+                    return -1;
+                }
+
+                scr_spatial_sids = sids;
+                scr_spatial_sids_capacity = length;
+            }
+        }
+    }
+
+    scr_spatial_dirty = false;
+    scr_spatial_rebuilds++;
+
+    return 0;
+}
+
+static void scr_spatial_index_free()
+{
+    if (scr_spatial_sids != NULL) {
+        mem_free(scr_spatial_sids);
+        scr_spatial_sids = NULL;
+    }
+
+    scr_spatial_sids_capacity = 0;
+    scr_spatial_dirty = true;
+}
+
 // 0x4940D0
 int scr_new(int* sidPtr, int scriptType)
 {
@@ -2030,6 +2457,10 @@ int scr_new(int* sidPtr, int scriptType)
         scr->procs[index] = SCRIPT_PROC_NO_PROC;
     }
 
+    if (scr_index_set(sid, scr) == -1) {
+        return -1;
+    }
+
     scriptListExtent->length++;
 
     return 0;
@@ -2126,6 +2557,8 @@ int scr_remove(int sid)
             debug_printf("\nERROR Removing Timed Events on scr_remove!!\n");
         }
 
+        scr_index_remove(sid, script);
+
         if (scriptListExtent == scriptList->tail && index + 1 == scriptListExtent->length) {
             // Removing last script in tail extent
             scriptListExtent->length -= 1;
@@ -2149,6 +2582,7 @@ int scr_remove(int sid)
         } else {
             // Relocate last script from tail extent into this script's slot.
             memcpy(&(scriptListExtent->scripts[index]), &(scriptList->tail->scripts[scriptList->tail->length - 1]), sizeof(Script));
+            scr_index_set(script->scr_id, script);
 
             // Decrement number of scripts in tail extent.
             scriptList->tail->length -= 1;
@@ -2238,6 +2672,8 @@ int scr_remove_all_force()
         scriptList->length = 0;
     }
 
+    scr_index_clear();
+
     scr_find_first_idx = 0;
     scr_find_first_ptr = 0;
     scr_find_first_elev = 0;
@@ -2248,6 +2684,87 @@ int scr_remove_all_force()
     return 0;
 }
 
+// Renames script [sid] to [newSid].
+//
+// The script is located by [sid] even if its `scr_id` has already been
+// overwritten (for example by restoring a saved copy over it).
+int scr_change_id(int sid, int newSid)
+{
+    ScriptIndexEntry* entry = scr_index_find(sid);
+    if (entry == NULL) {
+        return -1;
+    }
+
+    Script* script = entry->script;
+    scr_index_remove(sid, script);
+
+    script->scr_id = newSid;
+
+    return scr_index_set(newSid, script);
+}
+
+// Prints number of [scr_ptr] lookups since last call into [dest] and resets
+// the counter. Calling it once per frame gives lookups per frame.
+bool scr_index_stats(char* dest)
+{
+    if (dest == NULL) {
+        return false;
+    }
+
+    sprintf(dest, "Script index: %d lookups, %d scripts, capacity %d, scripts.lst read %d times in %u ms.\n", scr_index_lookups, scr_index_length, scr_index_capacity, scr_list_reads, scr_list_read_time);
+    scr_index_lookups = 0;
+    scr_list_reads = 0;
+    scr_list_read_time = 0;
+
+    return true;
+}
+
+// Prints number of spatial checks, scripts they visited and spatial index
+// rebuilds since last call into [dest] and resets the counters.
+bool scr_spatial_stats(char* dest)
+{
+    if (dest == NULL) {
+        return false;
+    }
+
+    sprintf(dest, "Spatial index: %d checks, %d scripts visited, %d rebuilds.\n", scr_spatial_checks, scr_spatial_visited, scr_spatial_rebuilds);
+    scr_spatial_checks = 0;
+    scr_spatial_visited = 0;
+    scr_spatial_rebuilds = 0;
+
+    return true;
+}
+
+// Cross-checks [scr_index] against a full scan of [scriptlists].
+bool scr_index_validate()
+{
+    int count = 0;
+    bool valid = true;
+
+    for (int type = 0; type < SCRIPT_TYPE_COUNT; type++) {
+        ScriptListExtent* extent = scriptlists[type].head;
+        while (extent != NULL) {
+            for (int index = 0; index < extent->length; index++) {
+                Script* script = &(extent->scripts[index]);
+                ScriptIndexEntry* entry = scr_index_find(script->scr_id);
+                if (entry == NULL || entry->script != script) {
+                    debug_printf("\nError: scr_index_validate: script %d is not indexed", script->scr_id);
+                    valid = false;
+                }
+                count++;
+            }
+            extent = extent->next;
+        }
+    }
+
+    if (count != scr_index_length) {
+        debug_printf("\nError: scr_index_validate: %d scripts, %d indexed", count, scr_index_length);
+        valid = false;
+    }
+
+    return valid;
+}
+
 // 0x4946F0
 Script* scr_find_first_at(int elevation)
 {
@@ -2358,8 +2875,37 @@ bool scr_chk_spatials_in(Object* object, int tile, int elevation)
 
     built_tile = builtTileCreate(tile, elevation);
 
-    script = scr_find_first_at(elevation);
-    while (script != NULL) {
+    if (scr_spatial_dirty) {
+        if (scr_spatial_index_rebuild() == -1) {
+            scr_spatials_enable();
+            return false;
+        }
+    }
+
+    // Spatial procs can add or remove scripts, cell bounds are taken up front
+    // and every sid is looked up again.
+    int start = 0;
+    int end = 0;
+    if (hexGridTileIsValid(tile) && elevationIsValid(elevation)) {
+        int cell = scr_spatial_cell(tile, elevation);
+        start = scr_spatial_cell_start[cell];
+        end = scr_spatial_cell_start[cell + 1];
+    }
+
+    scr_spatial_checks++;
+    scr_spatial_visited += end - start;
+
+    for (int index = start; index < end; index++) {
+        ScriptIndexEntry* entry = scr_index_find(scr_spatial_sids[index]);
+        if (entry == NULL) {
+            continue;
+        }
+
+        script = entry->script;
+        if ((script->scr_flags & SCRIPT_FLAG_0x02) != 0 || builtTileGetElevation(script->sp.built_tile) != elevation) {
+            continue;
+        }
+
         if (built_tile == script->sp.built_tile) {
             // NOTE: Uninline.
             scr_set_objs(script->scr_id, object, NULL);
@@ -2373,8 +2919,6 @@ bool scr_chk_spatials_in(Object* object, int tile, int elevation)
                 }
             }
         }
-
-        script = scr_find_next_at();
     }
 
     scr_spatials_enable();
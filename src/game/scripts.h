@@ -200,6 +200,10 @@ int scr_remove_local_vars(Script* script);
 int scr_remove(int index);
 int scr_remove_all();
 int scr_remove_all_force();
+int scr_change_id(int sid, int newSid);
+bool scr_index_stats(char* dest);
+bool scr_spatial_stats(char* dest);
+bool scr_index_validate();
 Script* scr_find_first_at(int elevation);
 Script* scr_find_next_at();
 bool scr_spatials_enabled();
@@ -31,6 +31,27 @@
 
 #define HEALABLE_DAMAGE_FLAGS_LENGTH 5
 
+// Number of entries in [skill_cache], must be a power of two.
+#define SKILL_CACHE_SIZE 256
+
+// Skill values of critters sharing the same proto and [stat_cache_flags],
+// an entry of [skill_cache].
+typedef struct SkillCacheEntry {
+    int pid;
+    int flags;
+
+    // Value of [stat_cache_generation] values were computed at, zero if
+    // this entry is unused.
+    unsigned int generation;
+
+    int points[SKILL_COUNT];
+
+    // Skill values before perk and game difficulty adjustments and clamping.
+    int values[SKILL_COUNT];
+} SkillCacheEntry;
+
+static int skill_level_uncached(Object* critter, int skill);
+static SkillCacheEntry* skill_cache_entry(Object* critter);
 static void show_skill_use_messages(Object* obj, int skill, Object* a3, int a4, int a5);
 static int skill_game_difficulty(int skill);
 static int skill_use_slot_available(int skill);
@@ -93,6 +114,10 @@ static int tag_skill[NUM_TAGGED_SKILLS];
 // 0x665000
 static MessageList skill_message_file;
 
+// Direct-mapped cache of skill values keyed by proto and
+// [stat_cache_flags].
+static SkillCacheEntry skill_cache[SKILL_CACHE_SIZE];
+
 // 0x498174
 int skill_init()
 {
@@ -131,6 +156,8 @@ int skill_init()
         tag_skill[index] = -1;
     }
 
+    stat_cache_invalidate();
+
     // NOTE: Uninline.
     skill_use_slot_clear();
 
@@ -146,6 +173,8 @@ void skill_reset()
         tag_skill[index] = -1;
     }
 
+    stat_cache_invalidate();
+
     // NOTE: Uninline.
     skill_use_slot_clear();
 }
@@ -159,6 +188,7 @@ void skill_exit()
 // 0x4982E4
 int skill_load(DB_FILE* stream)
 {
+    stat_cache_invalidate();
     return db_freadIntCount(stream, tag_skill, NUM_TAGGED_SKILLS);
 }
 
@@ -176,6 +206,8 @@ void skill_set_defaults(CritterProtoData* data)
     for (index = 0; index < SKILL_COUNT; index++) {
         data->skills[index] = 0;
     }
+
+    stat_cache_invalidate();
 }
 
 // 0x498340
@@ -186,6 +218,8 @@ void skill_set_tags(int* skills, int count)
     for (index = 0; index < count; index++) {
         tag_skill[index] = skills[index];
     }
+
+    stat_cache_invalidate();
 }
 
 // 0x498364
@@ -200,6 +234,44 @@ void skill_get_tags(int* skills, int count)
 
 // 0x498388
 int skill_level(Object* critter, int skill)
+{
+    if (skill < 0 || skill >= SKILL_COUNT) {
+        return -5;
+    }
+
+    SkillCacheEntry* entry = skill_cache_entry(critter);
+    if (entry == NULL) {
+        return skill_level_uncached(critter, skill);
+    }
+
+    if (entry->points[skill] < 0) {
+        return entry->points[skill];
+    }
+
+    int value = entry->values[skill];
+
+    if (critter == obj_dude) {
+        value += perk_adjust_skill(skill);
+        value += skill_game_difficulty(skill);
+    }
+
+    if (value > SKILL_LEVEL_MAX) {
+        value = SKILL_LEVEL_MAX;
+    }
+
+    if (stat_cache_check_enabled()) {
+        int expected = skill_level_uncached(critter, skill);
+        if (value != expected) {
+            debug_printf("\nError: skill_level: cached skill %d of pid %d is %d, expected %d", skill, critter->pid, value, expected);
+            value = expected;
+        }
+    }
+
+    return value;
+}
+
+// Computes [skill_level] bypassing [skill_cache].
+static int skill_level_uncached(Object* critter, int skill)
 {
     SkillDescription* skill_description;
     int points;
@@ -242,6 +314,59 @@ int skill_level(Object* critter, int skill)
     return value;
 }
 
+// Returns up to date cache entry for [critter], or `NULL` if its proto is
+// not available.
+static SkillCacheEntry* skill_cache_entry(Object* critter)
+{
+    int flags = stat_cache_flags(critter);
+
+    unsigned int hash = (unsigned int)critter->pid ^ ((unsigned int)flags << 24);
+    hash ^= hash >> 16;
+    hash *= 0x45D9F3B;
+    hash ^= hash >> 16;
+
+    SkillCacheEntry* entry = &(skill_cache[hash & (SKILL_CACHE_SIZE - 1)]);
+    if (entry->generation == stat_cache_generation() && entry->pid == critter->pid && entry->flags == flags) {
+        return entry;
+    }
+
+    Proto* proto;
+    if (proto_ptr(critter->pid, &proto) == -1) {
+        return NULL;
+    }
+
+    for (int skill = 0; skill < SKILL_COUNT; skill++) {
+        SkillDescription* skill_description = &(skill_data[skill]);
+        int points = proto->critter.data.skills[skill];
+        int bonus;
+
+        if (skill_description->stat2 != -1) {
+            bonus = (stat_level(critter, skill_description->stat1) + stat_level(critter, skill_description->stat2)) * skill_description->stat_modifier / 2;
+        } else {
+            bonus = stat_level(critter, skill_description->stat1) * skill_description->stat_modifier;
+        }
+
+        int value = skill_description->default_value + bonus + points * skill_description->points_modifier;
+
+        if ((flags & STAT_CACHE_DUDE) != 0) {
+            if (skill == tag_skill[0] || skill == tag_skill[1] || skill == tag_skill[2] || skill == tag_skill[3]) {
+                value += 20 + points * skill_description->points_modifier;
+            }
+
+            value += trait_adjust_skill(skill);
+        }
+
+        entry->points[skill] = points;
+        entry->values[skill] = value;
+    }
+
+    entry->pid = critter->pid;
+    entry->flags = flags;
+    entry->generation = stat_cache_generation();
+
+    return entry;
+}
+
 // 0x49847C
 int skill_base(int skill)
 {
@@ -292,6 +417,7 @@ int skill_inc_point(Object* obj, int skill)
     rc = stat_pc_set(PC_STAT_UNSPENT_SKILL_POINTS, unspent_skill_points - 1);
     if (rc == 0) {
         proto->critter.data.skills[skill] += 1;
+        stat_cache_invalidate();
     }
 
     return rc;
@@ -323,6 +449,7 @@ int skill_dec_point(Object* critter, int skill)
     rc = stat_pc_set(PC_STAT_UNSPENT_SKILL_POINTS, unspent_skill_points + 1);
     if (rc == 0) {
         proto->critter.data.skills[skill] -= 1;
+        stat_cache_invalidate();
     }
 
     return 0;
@@ -6,6 +6,7 @@
 #include "game/critter.h"
 #include "game/display.h"
 #include "game/game.h"
+#include "game/gconfig.h"
 #include "game/gsound.h"
 #include "game/intface.h"
 #include "game/item.h"
@@ -18,9 +19,13 @@
 #include "game/skill.h"
 #include "game/tile.h"
 #include "game/trait.h"
+#include "plib/gnw/debug.h"
 #include "plib/gnw/input.h"
 #include "plib/gnw/memory.h"
 
+// Number of entries in [stat_cache], must be a power of two.
+#define STAT_CACHE_SIZE 256
+
 // Provides metadata about stats.
 typedef struct StatDescription {
     char* name;
@@ -31,6 +36,24 @@ typedef struct StatDescription {
     int defaultValue;
 } StatDescription;
 
+// Saveable stat values of critters sharing the same proto and
+// [stat_cache_flags], an entry of [stat_cache].
+typedef struct StatCacheEntry {
+    int pid;
+    int flags;
+
+    // Value of [stat_generation] values were computed at, zero if this entry
+    // is unused.
+    unsigned int generation;
+
+    // Sum of base (including traits), bonus, and damage adjustments of every
+    // stat, before combat and age adjustments and clamping.
+    int values[SAVEABLE_STAT_COUNT];
+} StatCacheEntry;
+
+static int stat_level_uncached(Object* critter, int stat);
+static StatCacheEntry* stat_cache_entry(Object* critter);
+
 // 0x507EC8
 static StatDescription stat_data[STAT_COUNT] = {
     { NULL, NULL, 0, PRIMARY_STAT_MIN, PRIMARY_STAT_MAX, 5 },
@@ -91,6 +114,18 @@ static char* level_description[PRIMARY_STAT_RANGE];
 // 0x6651FC
 static int curr_pc_stat[PC_STAT_COUNT];
 
+// Direct-mapped cache of stat values keyed by proto and
+// [stat_cache_flags].
+static StatCacheEntry stat_cache[STAT_CACHE_SIZE];
+
+// Incremented every time something stat and skill values depend on is
+// changed, see [stat_cache_invalidate].
+static unsigned int stat_generation = 1;
+
+// When set, every cached stat and skill value is compared against uncached
+// evaluation.
+static bool stat_cache_check = false;
+
 // 0x49C2F0
 int stat_init()
 {
@@ -125,6 +160,10 @@ int stat_init()
         level_description[index] = getmsg(&stat_message_file, &messageListItem, 301 + index);
     }
 
+    bool checkCache = false;
+    configGetBool(&game_config, GAME_CONFIG_DEBUG_KEY, GAME_CONFIG_CHECK_STAT_CACHE_KEY, &checkCache);
+    stat_cache_set_check(checkCache);
+
     return 0;
 }
 
@@ -175,6 +214,46 @@ int stat_save(DB_FILE* stream)
 
 // 0x49C4C8
 int stat_level(Object* critter, int stat)
+{
+    if (stat < 0 || stat >= SAVEABLE_STAT_COUNT) {
+        return stat_level_uncached(critter, stat);
+    }
+
+    StatCacheEntry* entry = stat_cache_entry(critter);
+    if (entry == NULL) {
+        return stat_level_uncached(critter, stat);
+    }
+
+    int value = entry->values[stat];
+
+    switch (stat) {
+    case STAT_ARMOR_CLASS:
+        if (isInCombat()) {
+            if (combat_whose_turn() != critter) {
+                value += critter->data.critter.combat.ap;
+            }
+        }
+        break;
+    case STAT_AGE:
+        value += game_time() / GAME_TIME_TICKS_PER_YEAR;
+        break;
+    }
+
+    value = min(max(value, stat_data[stat].minimumValue), stat_data[stat].maximumValue);
+
+    if (stat_cache_check) {
+        int expected = stat_level_uncached(critter, stat);
+        if (value != expected) {
+            debug_printf("\nError: stat_level: cached stat %d of pid %d is %d, expected %d", stat, critter->pid, value, expected);
+            value = expected;
+        }
+    }
+
+    return value;
+}
+
+// Computes [stat_level] bypassing [stat_cache].
+static int stat_level_uncached(Object* critter, int stat)
 {
     int value;
     if (stat >= 0 && stat < SAVEABLE_STAT_COUNT) {
@@ -220,6 +299,104 @@ int stat_level(Object* critter, int stat)
     return value;
 }
 
+// Returns bits describing state of [critter] outside of its proto that
+// cached stat and skill values depend on.
+int stat_cache_flags(Object* critter)
+{
+    int flags = 0;
+
+    if (critter == obj_dude) {
+        flags |= STAT_CACHE_DUDE;
+
+        // See [trait_adjust_stat].
+        if (game_time_hour() - 600 < 1200) {
+            flags |= STAT_CACHE_DAYTIME;
+        }
+    }
+
+    if ((critter->data.critter.combat.results & DAM_BLIND) != 0) {
+        flags |= STAT_CACHE_BLIND;
+    }
+
+    return flags;
+}
+
+// Returns value which is changed every time cached stat and skill values
+// become stale.
+unsigned int stat_cache_generation()
+{
+    return stat_generation;
+}
+
+// Notifies that something stat and skill values depend on (protos, traits,
+// perks, tagged skills) was changed.
+void stat_cache_invalidate()
+{
+    stat_generation++;
+
+    // Zero is reserved for unused entries.
+    if (stat_generation == 0) {
+        for (int index = 0; index < STAT_CACHE_SIZE; index++) {
+            stat_cache[index].generation = 0;
+        }
+        stat_generation = 1;
+    }
+}
+
+// Enables comparing every cached stat and skill value against uncached
+// evaluation, mismatches are logged.
+void stat_cache_set_check(bool enabled)
+{
+    stat_cache_check = enabled;
+}
+
+bool stat_cache_check_enabled()
+{
+    return stat_cache_check;
+}
+
+// Returns up to date cache entry for [critter], or `NULL` if its proto is
+// not available.
+static StatCacheEntry* stat_cache_entry(Object* critter)
+{
+    int flags = stat_cache_flags(critter);
+
+    unsigned int hash = (unsigned int)critter->pid ^ ((unsigned int)flags << 24);
+    hash ^= hash >> 16;
+    hash *= 0x45D9F3B;
+    hash ^= hash >> 16;
+
+    StatCacheEntry* entry = &(stat_cache[hash & (STAT_CACHE_SIZE - 1)]);
+    if (entry->generation == stat_generation && entry->pid == critter->pid && entry->flags == flags) {
+        return entry;
+    }
+
+    Proto* proto;
+    if (proto_ptr(critter->pid, &proto) == -1) {
+        return NULL;
+    }
+
+    for (int stat = 0; stat < SAVEABLE_STAT_COUNT; stat++) {
+        int value = proto->critter.data.baseStats[stat] + proto->critter.data.bonusStats[stat];
+
+        if ((flags & STAT_CACHE_DUDE) != 0) {
+            value += trait_adjust_stat(stat);
+        }
+
+        if (stat == STAT_PERCEPTION && (flags & STAT_CACHE_BLIND) != 0) {
+            value -= 5;
+        }
+
+        entry->values[stat] = value;
+    }
+
+    entry->pid = critter->pid;
+    entry->flags = flags;
+    entry->generation = stat_generation;
+
+    return entry;
+}
+
 // Returns base stat value (accounting for traits if critter is dude).
 //
 // 0x49C5B8
@@ -297,6 +474,7 @@ int stat_set_base(Object* critter, int stat, int value)
 
         proto_ptr(critter->pid, &proto);
         proto->critter.data.baseStats[stat] = value;
+        stat_cache_invalidate();
 
         if (stat >= STAT_STRENGTH && stat <= STAT_LUCK) {
             stat_recalc_derived(critter);
@@ -353,6 +531,7 @@ int stat_set_bonus(Object* critter, int stat, int value)
         Proto* proto;
         proto_ptr(critter->pid, &proto);
         proto->critter.data.bonusStats[stat] = value;
+        stat_cache_invalidate();
 
         if (stat >= STAT_STRENGTH && stat <= STAT_LUCK) {
             stat_recalc_derived(critter);
@@ -383,6 +562,8 @@ void stat_set_defaults(CritterProtoData* data)
         data->baseStats[stat] = stat_data[stat].defaultValue;
         data->bonusStats[stat] = 0;
     }
+
+    stat_cache_invalidate();
 }
 
 // 0x49C8D4
@@ -410,6 +591,8 @@ void stat_recalc_derived(Object* critter)
     data->baseStats[STAT_BETTER_CRITICALS] = 0;
     data->baseStats[STAT_RADIATION_RESISTANCE] = 2 * endurance;
     data->baseStats[STAT_POISON_RESISTANCE] = 5 * endurance;
+
+    stat_cache_invalidate();
 }
 
 // 0x49CA2C
@@ -10,12 +10,22 @@
 
 #define STAT_ERR_INVALID_STAT -5
 
+// Bits of [stat_cache_flags].
+#define STAT_CACHE_DUDE 0x01
+#define STAT_CACHE_DAYTIME 0x02
+#define STAT_CACHE_BLIND 0x04
+
 int stat_init();
 int stat_reset();
 int stat_exit();
 int stat_load(DB_FILE* stream);
 int stat_save(DB_FILE* stream);
 int stat_level(Object* critter, int stat);
+int stat_cache_flags(Object* critter);
+unsigned int stat_cache_generation();
+void stat_cache_invalidate();
+void stat_cache_set_check(bool enabled);
+bool stat_cache_check_enabled();
 int stat_get_base(Object* critter, int stat);
 int stat_get_base_direct(Object* critter, int stat);
 int stat_get_bonus(Object* critter, int stat);
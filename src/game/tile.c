@@ -1,6 +1,8 @@
 #include "game/tile.h"
 
 #include <assert.h>
+#include <limits.h>
+#include <stdio.h>
 #include <string.h>
 
 #define _USE_MATH_DEFINES
@@ -16,9 +18,42 @@
 #include "plib/gnw/debug.h"
 #include "plib/gnw/grbuf.h"
 #include "plib/gnw/input.h"
+#include "plib/gnw/memory.h"
 
 #define TILE_IS_VALID(tile) ((tile) >= 0 && (tile) < grid_size)
 
+// Dimensions of floor tiles [floor_cache] can hold (which are dimensions of
+// [intensity_map] rows used by [floor_draw]).
+#define FLOOR_CACHE_TILE_WIDTH 80
+#define FLOOR_CACHE_TILE_HEIGHT 36
+
+// Amount of memory dedicated to pre-lit floor tiles.
+#define FLOOR_CACHE_BUDGET (1024 * 1024)
+
+#define FLOOR_CACHE_CAPACITY (FLOOR_CACHE_BUDGET / (FLOOR_CACHE_TILE_WIDTH * FLOOR_CACHE_TILE_HEIGHT))
+
+// Maximum number of separate rects [tile_dirty_rects] can hold, further rects
+// are merged into the closest one.
+#define TILE_DIRTY_RECTS_CAPACITY 32
+
+// Floor tile lit by specific set of vertex light levels.
+typedef struct FloorCacheEntry {
+    // Floor art fid, or -1 if this entry is unused.
+    int fid;
+
+    // Light levels of [verticies] this tile was lit with.
+    int light[10];
+
+    // Value of `intensityColorTableVersion` this tile was lit with.
+    unsigned int version;
+
+    // `true` if some opaque pixels were lit to color 0, in which case
+    // [pixels] cannot be copied with plain transparent blit.
+    bool hasZero;
+
+    unsigned char* pixels;
+} FloorCacheEntry;
+
 typedef struct STRUCT_51D99C {
     int field_0;
     int field_4;
@@ -50,10 +85,26 @@ typedef struct STRUCT_51DB48 {
 
 static void refresh_mapper(Rect* rect, int elevation);
 static void refresh_game(Rect* rect, int elevation);
+static void draw_mapper(Rect* rect, int elevation);
+static void draw_game(Rect* rect, int elevation);
 static bool tile_on_edge(int tile);
 static void roof_fill_on(int x, int y, int elevation);
 static void roof_fill_off(int x, int y, int elevation);
 static void roof_draw(int fid, int x, int y, Rect* rect, int light);
+static void floor_build_intensity_map();
+static FloorCacheEntry* floor_cache_entry(int fid);
+static bool floor_cache_find(FloorCacheEntry* entry, int fid);
+static void floor_cache_store(FloorCacheEntry* entry, int fid, unsigned char* data, int width, int height);
+static void floor_cache_free();
+static void tile_dirty_rect_add(Rect* rect);
+static bool tile_dirty_rects_can_merge(const Rect* a, const Rect* b);
+static int tile_rect_area(const Rect* rect);
+static void tile_render_rect(Rect* rect, int elevation);
+static void tile_draw_rect(Rect* rect, int elevation);
+static bool tile_buf_is_current();
+static void tile_buf_sync();
+static void tile_scroll_display();
+static void tile_scroll_buf(int dx, int dy);
 
 // 0x51D950
 static bool borderInitialized = false;
@@ -73,6 +124,10 @@ static bool show_grid = false;
 // 0x51D964
 static TileWindowRefreshElevationProc* tile_refresh = refresh_game;
 
+// Renders rect already clipped to [buf_rect] into [buf] without pushing it to
+// the screen, the part of [tile_refresh] shared with [tile_scroll_display].
+static TileWindowRefreshElevationProc* tile_draw = draw_game;
+
 // 0x51D968
 static bool refresh_enabled = true;
 
@@ -165,6 +220,50 @@ static STRUCT_51DB48 upside_down_triangles[5] = {
 // 0x668224
 static int intensity_map[3280];
 
+// Direct-mapped cache of pre-lit floor tiles, keyed by fid and vertex light
+// levels. Lighting changes produce different keys, so entries never need to be
+// invalidated explicitly.
+static FloorCacheEntry floor_cache[FLOOR_CACHE_CAPACITY];
+
+// Single allocation holding pixels of all [floor_cache] entries.
+static unsigned char* floor_cache_pixels = NULL;
+
+static int floor_cache_hits = 0;
+static int floor_cache_misses = 0;
+
+// Rects requested with [tile_refresh_rect] while refresh is deferred, see
+// [tile_defer_refresh]. Overlapping and adjacent rects are merged as they
+// come, so each area is rendered once per frame.
+static Rect tile_dirty_rects[TILE_DIRTY_RECTS_CAPACITY];
+static int tile_dirty_rects_length = 0;
+
+// Elevation [tile_dirty_rects] were requested for.
+static int tile_dirty_elevation = 0;
+
+// Number of nested [tile_defer_refresh] calls.
+static int tile_refresh_defer_level = 0;
+
+static int tile_refresh_requested = 0;
+static int tile_refresh_rendered = 0;
+static int tile_refresh_pixels = 0;
+
+// Screen position of tile 0 and elevation [buf] contents were rendered for,
+// valid as long as [tile_buf_valid] is set. Moving center without refreshing
+// leaves contents in place, so [tile_scroll_display] can shift them later.
+static int tile_buf_origin_x = 0;
+static int tile_buf_origin_y = 0;
+static int tile_buf_elevation = 0;
+
+// Cleared when [buf] misses a refresh or is drawn to in a different frame,
+// the next scroll then redraws the whole window.
+static bool tile_buf_valid = false;
+
+// Number of [tile_scroll_display] calls which shifted [buf] and which had to
+// redraw the whole window, and time spent in both.
+static int tile_scroll_shifted = 0;
+static int tile_scroll_redrawn = 0;
+static unsigned int tile_scroll_time = 0;
+
 // 0x66B564
 static int dir_tile2[2][6];
 
@@ -419,8 +518,16 @@ int tile_init(TileData** a1, int squareGridWidth, int squareGridHeight, int hexG
     config_get_string(&game_config, GAME_CONFIG_SYSTEM_KEY, GAME_CONFIG_EXECUTABLE_KEY, &executable);
     if (stricmp(executable, "mapper") == 0) {
         tile_refresh = refresh_mapper;
+        tile_draw = draw_mapper;
+
+        // Mapper draws the window differently.
+        tile_invalidate_buf();
     }
 
+    // Rects requested by animations, floating text and mouse updates within
+    // one pass over background processes are rendered together at its end.
+    set_bk_frame_funcs(tile_defer_refresh, tile_flush_refresh);
+
     return 0;
 }
 
@@ -454,6 +561,11 @@ void tile_reset()
 // NOTE: Uncollapsed 0x4B129C.
 void tile_exit()
 {
+    set_bk_frame_funcs(NULL, NULL);
+    tile_refresh_defer_level = 0;
+    tile_dirty_rects_length = 0;
+
+    floor_cache_free();
 }
 
 // 0x4B12A8
@@ -473,8 +585,25 @@ void tile_refresh_rect(Rect* rect, int elevation)
 {
     if (refresh_enabled) {
         if (elevation == map_elevation) {
-            tile_refresh(rect, elevation);
+            tile_refresh_requested++;
+
+            if (!tile_buf_is_current()) {
+                tile_buf_valid = false;
+            }
+
+            if (tile_refresh_defer_level > 0) {
+                if (tile_dirty_rects_length != 0 && tile_dirty_elevation != elevation) {
+                    tile_flush_refresh_rects();
+                }
+
+                tile_dirty_elevation = elevation;
+                tile_dirty_rect_add(rect);
+            } else {
+                tile_render_rect(rect, elevation);
+            }
         }
+    } else {
+        tile_buf_valid = false;
     }
 }
 
@@ -482,7 +611,306 @@ void tile_refresh_rect(Rect* rect, int elevation)
 void tile_refresh_display()
 {
     if (refresh_enabled) {
-        tile_refresh(&buf_rect, map_elevation);
+        // Entire window is redrawn, pending rects are covered by it.
+        tile_dirty_rects_length = 0;
+
+        tile_refresh_requested++;
+        tile_render_rect(&buf_rect, map_elevation);
+        tile_buf_sync();
+    } else {
+        tile_buf_valid = false;
+    }
+}
+
+// Starts collecting rects passed to [tile_refresh_rect] instead of rendering
+// them immediately. Calls can be nested, each one must be paired with
+// [tile_flush_refresh].
+void tile_defer_refresh()
+{
+    tile_refresh_defer_level++;
+}
+
+// Renders rects collected since [tile_defer_refresh] and ends one level of
+// deferring.
+//
+// Rects are rendered even when outer level is still active, so that nested
+// loops (such as dialogs opened from scripts) keep updating the screen.
+void tile_flush_refresh()
+{
+    if (tile_refresh_defer_level > 0) {
+        tile_refresh_defer_level--;
+    }
+
+    tile_flush_refresh_rects();
+}
+
+// Renders and clears [tile_dirty_rects] without ending deferring.
+//
+// Must be called before anything that holds the screen still for a while
+// (palette fades, movies) when it may run from a background process, so it
+// does not show a frame missing rects deferred earlier in the same pass.
+void tile_flush_refresh_rects()
+{
+    // Rendering can trigger more refreshes (via window refresh procs), take
+    // pending rects out first.
+    Rect rects[TILE_DIRTY_RECTS_CAPACITY];
+    int length = tile_dirty_rects_length;
+    memcpy(rects, tile_dirty_rects, sizeof(*rects) * length);
+    tile_dirty_rects_length = 0;
+
+    if (!refresh_enabled || tile_dirty_elevation != map_elevation) {
+        return;
+    }
+
+    // Every rect is blitted on its own. Rects are only kept apart when their
+    // bound is larger than both of them, so blitting the bound would copy
+    // more than it saves on window refresh calls.
+    for (int index = 0; index < length; index++) {
+        tile_render_rect(&(rects[index]), tile_dirty_elevation);
+    }
+}
+
+// Adds [rect] to [tile_dirty_rects], merging it with rects it overlaps or
+// touches as long as that does not grow area to be redrawn.
+static void tile_dirty_rect_add(Rect* rect)
+{
+    Rect dirty;
+    if (rect_inside_bound(rect, &buf_rect, &dirty) == -1) {
+        return;
+    }
+
+    for (;;) {
+        int index;
+        for (index = 0; index < tile_dirty_rects_length; index++) {
+            if (tile_dirty_rects_can_merge(&(tile_dirty_rects[index]), &dirty)) {
+                break;
+            }
+        }
+
+        if (index == tile_dirty_rects_length) {
+            if (tile_dirty_rects_length < TILE_DIRTY_RECTS_CAPACITY) {
+                break;
+            }
+
+            // No room left, merge with rect which grows the least.
+            int bestGrowth = INT_MAX;
+            for (int candidate = 0; candidate < tile_dirty_rects_length; candidate++) {
+                Rect bound;
+                rect_min_bound(&(tile_dirty_rects[candidate]), &dirty, &bound);
+
+                int growth = tile_rect_area(&bound) - tile_rect_area(&(tile_dirty_rects[candidate]));
+                if (growth < bestGrowth) {
+                    bestGrowth = growth;
+                    index = candidate;
+                }
+            }
+        }
+
+        // Merged rect can now overlap others, so take it out and look again.
+        rect_min_bound(&(tile_dirty_rects[index]), &dirty, &dirty);
+        tile_dirty_rects[index] = tile_dirty_rects[tile_dirty_rects_length - 1];
+        tile_dirty_rects_length--;
+    }
+
+    tile_dirty_rects[tile_dirty_rects_length] = dirty;
+    tile_dirty_rects_length++;
+}
+
+// Returns `true` if [a] and [b] overlap or touch and their bounding rect is
+// not larger than both of them taken separately.
+static bool tile_dirty_rects_can_merge(const Rect* a, const Rect* b)
+{
+    if (a->ulx > b->lrx + 1 || b->ulx > a->lrx + 1 || a->uly > b->lry + 1 || b->uly > a->lry + 1) {
+        return false;
+    }
+
+    Rect bound;
+    rect_min_bound(a, b, &bound);
+
+    return tile_rect_area(&bound) <= tile_rect_area(a) + tile_rect_area(b);
+}
+
+static int tile_rect_area(const Rect* rect)
+{
+    return (rect->lrx - rect->ulx + 1) * (rect->lry - rect->uly + 1);
+}
+
+// Renders [rect] (in window coordinates) and pushes it to the screen.
+static void tile_render_rect(Rect* rect, int elevation)
+{
+    Rect rectToUpdate;
+    if (rect_inside_bound(rect, &buf_rect, &rectToUpdate) == -1) {
+        return;
+    }
+
+    tile_refresh_rendered++;
+    tile_refresh_pixels += tile_rect_area(&rectToUpdate);
+
+    tile_refresh(&rectToUpdate, elevation);
+}
+
+// Renders [rect] (in window coordinates) into [buf] the same way
+// [tile_refresh] does, but leaves pushing it to the screen to the caller.
+static void tile_draw_rect(Rect* rect, int elevation)
+{
+    Rect rectToUpdate;
+    if (rect_inside_bound(rect, &buf_rect, &rectToUpdate) == -1) {
+        return;
+    }
+
+    tile_refresh_rendered++;
+    tile_refresh_pixels += tile_rect_area(&rectToUpdate);
+
+    tile_draw(&rectToUpdate, elevation);
+}
+
+// Prints number of rects requested with [tile_refresh_rect] and
+// [tile_refresh_display], number of rects actually rendered after merging,
+// and number of pixels they covered.
+bool tile_refresh_stats(char* dest)
+{
+    if (dest == NULL) {
+        return false;
+    }
+
+    sprintf(dest, "Tile refresh: %d rects requested, %d rendered, %d pixels.\n", tile_refresh_requested, tile_refresh_rendered, tile_refresh_pixels);
+
+    return true;
+}
+
+// Prints number of center changes which reused shifted window contents,
+// number of those which redrew the whole window, and milliseconds spent in
+// both. Walking with the camera following the dude should mostly shift.
+bool tile_scroll_stats(char* dest)
+{
+    if (dest == NULL) {
+        return false;
+    }
+
+    sprintf(dest, "Tile scroll: %d shifted, %d redrawn, %u ms.\n", tile_scroll_shifted, tile_scroll_redrawn, tile_scroll_time);
+
+    return true;
+}
+
+// Returns `true` if [buf] holds current center and elevation.
+static bool tile_buf_is_current()
+{
+    int originX;
+    int originY;
+    tile_coord(0, &originX, &originY, map_elevation);
+
+    return tile_buf_valid
+        && tile_buf_elevation == map_elevation
+        && tile_buf_origin_x == originX
+        && tile_buf_origin_y == originY;
+}
+
+// Forces next center change to redraw the whole window instead of shifting
+// [buf], for when its contents no longer belong to the current map.
+void tile_invalidate_buf()
+{
+    tile_buf_valid = false;
+}
+
+// Marks [buf] as up to date with current center and elevation.
+static void tile_buf_sync()
+{
+    tile_coord(0, &tile_buf_origin_x, &tile_buf_origin_y, map_elevation);
+    tile_buf_elevation = map_elevation;
+    tile_buf_valid = true;
+}
+
+// Refreshes window after center change.
+//
+// Every hex moves by the same offset when center changes, so contents of
+// [buf] are shifted by it and only the L-shaped area which scrolled into view
+// is rendered. The window is pushed to the screen once, after both strips are
+// drawn. Rects still waiting in [tile_dirty_rects] are moved along.
+static void tile_scroll_display()
+{
+    if (!refresh_enabled) {
+        tile_buf_valid = false;
+        return;
+    }
+
+    unsigned int start = get_time();
+
+    int originX;
+    int originY;
+    tile_coord(0, &originX, &originY, map_elevation);
+
+    int dx = originX - tile_buf_origin_x;
+    int dy = originY - tile_buf_origin_y;
+
+    if (!tile_buf_valid
+        || tile_buf_elevation != map_elevation
+        || (dx == 0 && dy == 0)
+        || abs(dx) >= buf_width
+        || abs(dy) >= buf_length) {
+        tile_refresh_display();
+        tile_scroll_redrawn++;
+        tile_scroll_time += elapsed_tocks(get_time(), start);
+        return;
+    }
+
+    tile_scroll_buf(dx, dy);
+
+    int index = 0;
+    while (index < tile_dirty_rects_length) {
+        Rect* rect = &(tile_dirty_rects[index]);
+        rectOffset(rect, dx, dy);
+        if (rect_inside_bound(rect, &buf_rect, rect) == -1) {
+            tile_dirty_rects[index] = tile_dirty_rects[tile_dirty_rects_length - 1];
+            tile_dirty_rects_length--;
+        } else {
+            index++;
+        }
+    }
+
+    // Rendering can request more refreshes, they are in the new frame.
+    tile_buf_sync();
+
+    if (dx != 0) {
+        Rect column;
+        column.ulx = dx > 0 ? 0 : buf_width + dx;
+        column.uly = 0;
+        column.lrx = dx > 0 ? dx - 1 : buf_width - 1;
+        column.lry = buf_length - 1;
+        tile_draw_rect(&column, map_elevation);
+    }
+
+    if (dy != 0) {
+        Rect row;
+        row.ulx = dx > 0 ? dx : 0;
+        row.uly = dy > 0 ? 0 : buf_length + dy;
+        row.lrx = dx < 0 ? buf_width + dx - 1 : buf_width - 1;
+        row.lry = dy > 0 ? dy - 1 : buf_length - 1;
+        tile_draw_rect(&row, map_elevation);
+    }
+
+    blit(&buf_rect);
+
+    tile_scroll_shifted++;
+    tile_scroll_time += elapsed_tocks(get_time(), start);
+}
+
+// Moves contents of [buf] by [dx], [dy] pixels, the uncovered area is left
+// as is.
+static void tile_scroll_buf(int dx, int dy)
+{
+    int width = buf_width - abs(dx);
+    int height = buf_length - abs(dy);
+    int srcX = dx < 0 ? -dx : 0;
+    int destX = dx > 0 ? dx : 0;
+
+    if (dy > 0) {
+        for (int y = height - 1; y >= 0; y--) {
+            memmove(buf + buf_full * (y + dy) + destX, buf + buf_full * y + srcX, width);
+        }
+    } else {
+        for (int y = 0; y < height; y++) {
+            memmove(buf + buf_full * y + destX, buf + buf_full * (y - dy) + srcX, width);
+        }
     }
 }
 
@@ -553,8 +981,7 @@ int tile_set_center(int tile, int flags)
     tile_center_tile = tile;
 
     if ((flags & TILE_SET_CENTER_REFRESH_WINDOW) != 0) {
-        // NOTE: Uninline.
-        tile_refresh_display();
+        tile_scroll_display();
     }
 
     return 0;
@@ -569,17 +996,7 @@ static void refresh_mapper(Rect* rect, int elevation)
         return;
     }
 
-    buf_fill(buf + buf_full * rectToUpdate.uly + rectToUpdate.ulx,
-        rectToUpdate.lrx - rectToUpdate.ulx + 1,
-        rectToUpdate.lry - rectToUpdate.uly + 1,
-        buf_full,
-        0);
-
-    square_render_floor(&rectToUpdate, elevation);
-    grid_render(&rectToUpdate, elevation);
-    obj_render_pre_roof(&rectToUpdate, elevation);
-    square_render_roof(&rectToUpdate, elevation);
-    obj_render_post_roof(&rectToUpdate, elevation);
+    draw_mapper(&rectToUpdate, elevation);
     blit(&rectToUpdate);
 }
 
@@ -592,13 +1009,35 @@ static void refresh_game(Rect* rect, int elevation)
         return;
     }
 
-    square_render_floor(&rectToUpdate, elevation);
-    obj_render_pre_roof(&rectToUpdate, elevation);
-    square_render_roof(&rectToUpdate, elevation);
-    obj_render_post_roof(&rectToUpdate, elevation);
+    draw_game(&rectToUpdate, elevation);
     blit(&rectToUpdate);
 }
 
+// Draws [rect] of mapper window, which is cleared first and shows the grid.
+static void draw_mapper(Rect* rect, int elevation)
+{
+    buf_fill(buf + buf_full * rect->uly + rect->ulx,
+        rect->lrx - rect->ulx + 1,
+        rect->lry - rect->uly + 1,
+        buf_full,
+        0);
+
+    square_render_floor(rect, elevation);
+    grid_render(rect, elevation);
+    obj_render_pre_roof(rect, elevation);
+    square_render_roof(rect, elevation);
+    obj_render_post_roof(rect, elevation);
+}
+
+// Draws [rect] of game window.
+static void draw_game(Rect* rect, int elevation)
+{
+    square_render_floor(rect, elevation);
+    obj_render_pre_roof(rect, elevation);
+    square_render_roof(rect, elevation);
+    obj_render_post_roof(rect, elevation);
+}
+
 // 0x4B1634
 void tile_toggle_roof(int a1)
 {
@@ -1718,114 +2157,28 @@ void floor_draw(int fid, int x, int y, Rect* rect)
             goto out;
         }
 
-        for (int i = 0; i < 5; i++) {
-            STRUCT_51DB0C* ptr_51DB0C = &(rightside_up_triangles[i]);
-            int v32 = verticies[ptr_51DB0C->field_8].field_C;
-            int v33 = verticies[ptr_51DB0C->field_8].field_0;
-            int v34 = verticies[ptr_51DB0C->field_4].field_C - verticies[ptr_51DB0C->field_0].field_C;
-            // TODO: Probably wrong.
-            int v35 = v34 / 32;
-            int v36 = (verticies[ptr_51DB0C->field_0].field_C - v32) / 13;
-            int* v37 = &(intensity_map[v33]);
-            if (v35 != 0) {
-                if (v36 != 0) {
-                    for (int i = 0; i < 13; i++) {
-                        int v41 = v32;
-                        int v42 = rightside_up_table[i].field_4;
-                        v37 += rightside_up_table[i].field_0;
-                        for (int j = 0; j < v42; j++) {
-                            *v37++ = v41;
-                            v41 += v35;
-                        }
-                        v32 += v36;
-                    }
-                } else {
-                    for (int i = 0; i < 13; i++) {
-                        int v38 = v32;
-                        int v39 = rightside_up_table[i].field_4;
-                        v37 += rightside_up_table[i].field_0;
-                        for (int j = 0; j < v39; j++) {
-                            *v37++ = v38;
-                            v38 += v35;
-                        }
-                    }
-                }
-            } else {
-                if (v36 != 0) {
-                    for (int i = 0; i < 13; i++) {
-                        int v46 = rightside_up_table[i].field_4;
-                        v37 += rightside_up_table[i].field_0;
-                        for (int j = 0; j < v46; j++) {
-                            *v37++ = v32;
-                        }
-                        v32 += v36;
-                    }
-                } else {
-                    for (int i = 0; i < 13; i++) {
-                        int v44 = rightside_up_table[i].field_4;
-                        v37 += rightside_up_table[i].field_0;
-                        for (int j = 0; j < v44; j++) {
-                            *v37++ = v32;
-                        }
-                    }
-                }
-            }
+        FloorCacheEntry* cached = NULL;
+        if (frameWidth == FLOOR_CACHE_TILE_WIDTH && frameHeight <= FLOOR_CACHE_TILE_HEIGHT) {
+            cached = floor_cache_entry(fid);
         }
 
-        for (int i = 0; i < 5; i++) {
-            STRUCT_51DB48* ptr_51DB48 = &(upside_down_triangles[i]);
-            int v50 = verticies[ptr_51DB48->field_0].field_C;
-            int v51 = verticies[ptr_51DB48->field_0].field_0;
-            int v52 = verticies[ptr_51DB48->field_8].field_C - v50;
-            // TODO: Probably wrong.
-            int v53 = v52 / 32;
-            int v54 = (verticies[ptr_51DB48->field_4].field_C - v50) / 13;
-            int* v55 = &(intensity_map[v51]);
-            if (v53 != 0) {
-                if (v54 != 0) {
-                    for (int i = 0; i < 13; i++) {
-                        int v59 = v50;
-                        int v60 = upside_down_table[i].field_4;
-                        v55 += upside_down_table[i].field_0;
-                        for (int j = 0; j < v60; j++) {
-                            *v55++ = v59;
-                            v59 += v53;
-                        }
-                        v50 += v54;
-                    }
-                } else {
-                    for (int i = 0; i < 13; i++) {
-                        int v56 = v50;
-                        int v57 = upside_down_table[i].field_4;
-                        v55 += upside_down_table[i].field_0;
-                        for (int j = 0; j < v57; j++) {
-                            *v55++ = v56;
-                            v56 += v53;
-                        }
-                    }
-                }
+        if (cached != NULL) {
+            if (!floor_cache_find(cached, fid)) {
+                floor_build_intensity_map();
+                floor_cache_store(cached, fid, art_frame_data(art, 0, 0), frameWidth, frameHeight);
+            }
+
+            unsigned char* pixels = cached->pixels + frameWidth * v78 + v79;
+            if (cached->hasZero) {
+                mask_buf_to_buf(pixels, v77, v76, frameWidth, art_frame_data(art, 0, 0) + frameWidth * v78 + v79, frameWidth, buf + buf_full * y + x, buf_full);
             } else {
-                if (v54 != 0) {
-                    for (int i = 0; i < 13; i++) {
-                        int v64 = upside_down_table[i].field_4;
-                        v55 += upside_down_table[i].field_0;
-                        for (int j = 0; j < v64; j++) {
-                            *v55++ = v50;
-                        }
-                        v50 += v54;
-                    }
-                } else {
-                    for (int i = 0; i < 13; i++) {
-                        int v62 = upside_down_table[i].field_4;
-                        v55 += upside_down_table[i].field_0;
-                        for (int j = 0; j < v62; j++) {
-                            *v55++ = v50;
-                        }
-                    }
-                }
+                trans_buf_to_buf(pixels, v77, v76, frameWidth, buf + buf_full * y + x, buf_full);
             }
+            goto out;
         }
 
+        floor_build_intensity_map();
+
         unsigned char* v66 = buf + buf_full * y + x;
         unsigned char* v67 = art_frame_data(art, 0, 0) + frameWidth * v78 + v79;
         int* v68 = &(intensity_map[160 + 80 * v78]) + v79;
@@ -1853,6 +2206,219 @@ out:
     art_ptr_unlock(cacheEntry);
 }
 
+// Fills [intensity_map] by interpolating light levels of [verticies].
+//
+// Every call writes the same cells, cells outside of the triangles are never
+// written and stay 0. This makes the map a function of [verticies] alone,
+// which is what lets [floor_cache] key lit tiles by their light levels.
+static void floor_build_intensity_map()
+{
+    for (int i = 0; i < 5; i++) {
+        STRUCT_51DB0C* ptr_51DB0C = &(rightside_up_triangles[i]);
+        int v32 = verticies[ptr_51DB0C->field_8].field_C;
+        int v33 = verticies[ptr_51DB0C->field_8].field_0;
+        int v34 = verticies[ptr_51DB0C->field_4].field_C - verticies[ptr_51DB0C->field_0].field_C;
+        // TODO: Probably wrong.
+        int v35 = v34 / 32;
+        int v36 = (verticies[ptr_51DB0C->field_0].field_C - v32) / 13;
+        int* v37 = &(intensity_map[v33]);
+        if (v35 != 0) {
+            if (v36 != 0) {
+                for (int i = 0; i < 13; i++) {
+                    int v41 = v32;
+                    int v42 = rightside_up_table[i].field_4;
+                    v37 += rightside_up_table[i].field_0;
+                    for (int j = 0; j < v42; j++) {
+                        *v37++ = v41;
+                        v41 += v35;
+                    }
+                    v32 += v36;
+                }
+            } else {
+                for (int i = 0; i < 13; i++) {
+                    int v38 = v32;
+                    int v39 = rightside_up_table[i].field_4;
+                    v37 += rightside_up_table[i].field_0;
+                    for (int j = 0; j < v39; j++) {
+                        *v37++ = v38;
+                        v38 += v35;
+                    }
+                }
+            }
+        } else {
+            if (v36 != 0) {
+                for (int i = 0; i < 13; i++) {
+                    int v46 = rightside_up_table[i].field_4;
+                    v37 += rightside_up_table[i].field_0;
+                    for (int j = 0; j < v46; j++) {
+                        *v37++ = v32;
+                    }
+                    v32 += v36;
+                }
+            } else {
+                for (int i = 0; i < 13; i++) {
+                    int v44 = rightside_up_table[i].field_4;
+                    v37 += rightside_up_table[i].field_0;
+                    for (int j = 0; j < v44; j++) {
+                        *v37++ = v32;
+                    }
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < 5; i++) {
+        STRUCT_51DB48* ptr_51DB48 = &(upside_down_triangles[i]);
+        int v50 = verticies[ptr_51DB48->field_0].field_C;
+        int v51 = verticies[ptr_51DB48->field_0].field_0;
+        int v52 = verticies[ptr_51DB48->field_8].field_C - v50;
+        // TODO: Probably wrong.
+        int v53 = v52 / 32;
+        int v54 = (verticies[ptr_51DB48->field_4].field_C - v50) / 13;
+        int* v55 = &(intensity_map[v51]);
+        if (v53 != 0) {
+            if (v54 != 0) {
+                for (int i = 0; i < 13; i++) {
+                    int v59 = v50;
+                    int v60 = upside_down_table[i].field_4;
+                    v55 += upside_down_table[i].field_0;
+                    for (int j = 0; j < v60; j++) {
+                        *v55++ = v59;
+                        v59 += v53;
+                    }
+                    v50 += v54;
+                }
+            } else {
+                for (int i = 0; i < 13; i++) {
+                    int v56 = v50;
+                    int v57 = upside_down_table[i].field_4;
+                    v55 += upside_down_table[i].field_0;
+                    for (int j = 0; j < v57; j++) {
+                        *v55++ = v56;
+                        v56 += v53;
+                    }
+                }
+            }
+        } else {
+            if (v54 != 0) {
+                for (int i = 0; i < 13; i++) {
+                    int v64 = upside_down_table[i].field_4;
+                    v55 += upside_down_table[i].field_0;
+                    for (int j = 0; j < v64; j++) {
+                        *v55++ = v50;
+                    }
+                    v50 += v54;
+                }
+            } else {
+                for (int i = 0; i < 13; i++) {
+                    int v62 = upside_down_table[i].field_4;
+                    v55 += upside_down_table[i].field_0;
+                    for (int j = 0; j < v62; j++) {
+                        *v55++ = v50;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Returns [floor_cache] entry for floor tile [fid] lit with current
+// [verticies], or NULL if the cache cannot be allocated.
+static FloorCacheEntry* floor_cache_entry(int fid)
+{
+    if (floor_cache_pixels == NULL) {
+        floor_cache_pixels = (unsigned char*)mem_malloc(FLOOR_CACHE_CAPACITY * FLOOR_CACHE_TILE_WIDTH * FLOOR_CACHE_TILE_HEIGHT);
+        if (floor_cache_pixels == NULL) {
+            return NULL;
+        }
+
+        for (int index = 0; index < FLOOR_CACHE_CAPACITY; index++) {
+            floor_cache[index].fid = -1;
+            floor_cache[index].pixels = floor_cache_pixels + index * FLOOR_CACHE_TILE_WIDTH * FLOOR_CACHE_TILE_HEIGHT;
+        }
+    }
+
+    unsigned int hash = (unsigned int)fid * 16777619;
+    for (int index = 0; index < 10; index++) {
+        hash = (hash ^ (unsigned int)verticies[index].field_C) * 16777619;
+    }
+
+    return &(floor_cache[hash % FLOOR_CACHE_CAPACITY]);
+}
+
+// Returns `true` if [entry] holds floor tile [fid] lit with current
+// [verticies].
+static bool floor_cache_find(FloorCacheEntry* entry, int fid)
+{
+    if (entry->fid == fid && entry->version == intensityColorTableVersion) {
+        int index;
+        for (index = 0; index < 10; index++) {
+            if (entry->light[index] != verticies[index].field_C) {
+                break;
+            }
+        }
+
+        if (index == 10) {
+            floor_cache_hits++;
+            return true;
+        }
+    }
+
+    floor_cache_misses++;
+    return false;
+}
+
+// Lights [width]x[height] floor tile [fid] with [intensity_map] into [entry],
+// replacing whatever it held before.
+static void floor_cache_store(FloorCacheEntry* entry, int fid, unsigned char* data, int width, int height)
+{
+    entry->fid = fid;
+    entry->version = intensityColorTableVersion;
+    entry->hasZero = false;
+
+    for (int index = 0; index < 10; index++) {
+        entry->light[index] = verticies[index].field_C;
+    }
+
+    unsigned char* src = data;
+    unsigned char* dest = entry->pixels;
+    int* intensity = &(intensity_map[160]);
+    for (int index = 0; index < width * height; index++) {
+        if (*src != 0) {
+            *dest = intensityColorTable[*src][*intensity >> 9];
+            if (*dest == 0) {
+                entry->hasZero = true;
+            }
+        } else {
+            *dest = 0;
+        }
+        src++;
+        dest++;
+        intensity++;
+    }
+}
+
+static void floor_cache_free()
+{
+    if (floor_cache_pixels != NULL) {
+        mem_free(floor_cache_pixels);
+        floor_cache_pixels = NULL;
+    }
+}
+
+// Prints floor cache hit rate into [dest].
+bool floor_cache_stats(char* dest)
+{
+    if (dest == NULL) {
+        return false;
+    }
+
+    int total = floor_cache_hits + floor_cache_misses;
+    sprintf(dest, "Floor cache: %d hits, %d misses (%d%%).\n", floor_cache_hits, floor_cache_misses, total != 0 ? floor_cache_hits * 100 / total : 0);
+
+    return true;
+}
+
 // 0x4B372C
 int tile_make_line(int from, int to, int* tiles, int tilesCapacity)
 {
@@ -1996,8 +2562,7 @@ int tile_scroll_to(int tile, int flags)
     }
 
     if ((flags & 0x02) != 0) {
-        // NOTE: Uninline.
-        tile_refresh_display();
+        tile_scroll_display();
     }
 
     return rc;
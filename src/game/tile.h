@@ -25,6 +25,12 @@ void tile_disable_refresh();
 void tile_enable_refresh();
 void tile_refresh_rect(Rect* rect, int elevation);
 void tile_refresh_display();
+void tile_defer_refresh();
+void tile_flush_refresh();
+void tile_flush_refresh_rects();
+bool tile_refresh_stats(char* dest);
+bool tile_scroll_stats(char* dest);
+void tile_invalidate_buf();
 int tile_set_center(int tile, int flags);
 void tile_toggle_roof(int a1);
 int tile_roof_visible();
@@ -60,6 +66,7 @@ void grid_render(Rect* rect, int elevation);
 void grid_draw(int tile, int elevation);
 void draw_grid(int tile, int elevation, Rect* rect);
 void floor_draw(int fid, int x, int y, Rect* rect);
+bool floor_cache_stats(char* dest);
 int tile_make_line(int currentCenterTile, int newCenterTile, int* tiles, int tilesCapacity);
 int tile_scroll_to(int tile, int flags);
 
@@ -95,6 +95,8 @@ void trait_reset()
     for (index = 0; index < PC_TRAIT_MAX; index++) {
         pc_trait[index] = -1;
     }
+
+    stat_cache_invalidate();
 }
 
 // 0x4A0598
@@ -108,6 +110,7 @@ void trait_exit()
 // 0x4A05A8
 int trait_load(DB_FILE* stream)
 {
+    stat_cache_invalidate();
     return db_freadIntCount(stream, pc_trait, PC_TRAIT_MAX);
 }
 
@@ -126,6 +129,8 @@ void trait_set(int trait1, int trait2)
 {
     pc_trait[0] = trait1;
     pc_trait[1] = trait2;
+
+    stat_cache_invalidate();
 }
 
 // Returns selected traits.
@@ -27,6 +27,48 @@ typedef struct ProgramListNode {
     struct ProgramListNode* prev; // prev
 } ProgramListNode;
 
+// Decoded form of the instruction at an even offset in [Program.data].
+//
+// Instructions are decoded the first time they are executed and reused on
+// every subsequent pass, which saves byte-swapping and opcode validation in
+// the dispatch loop. Code and data tables are interleaved in the program file,
+// so decoding the whole file up front would misinterpret the tables.
+typedef struct ProgramInstruction {
+    // Handler from [opTable], or NULL if this slot has not been decoded yet.
+    OpcodeHandler* handler;
+    opcode_t opcode;
+
+    // Native-endian operand of `OPCODE_PUSH`.
+    int operand;
+} ProgramInstruction;
+
+// Number of decoded instruction slots allocated at once.
+//
+// Most of a program file is identifiers, strings and procedures that are never
+// executed, so slots are allocated only for pages of code that actually run.
+#define INSTRUCTION_PAGE_SIZE 256
+
+// Contents of a program file shared by every [Program] loaded from it.
+//
+// Code, identifiers and static strings are never written to, so they are read
+// once per path and reference-counted. The procedure table is the exception
+// (timed and conditional procedures keep their state there), so every
+// [Program] gets its own copy of it.
+struct ProgramImage {
+    char* path;
+    unsigned char* data;
+    int dataSize;
+    // Pages of [INSTRUCTION_PAGE_SIZE] decoded instructions, one slot per even
+    // offset in [data]. Pages are NULL until something in them is executed.
+    ProgramInstruction** instructionPages;
+    int instructionPagesLength;
+    // Number of [Program]s using this image.
+    int refCount;
+    // Value of [db_generation] the file was read at.
+    unsigned int generation;
+    struct ProgramImage* next;
+};
+
 static unsigned int defaultTimerFunc();
 static char* defaultFilename(char* fileName);
 static int outputStr(char* string);
@@ -46,7 +88,10 @@ static opcode_t rPopShort(Program* program);
 static int rPopLong(Program* program);
 static void detachProgram(Program* program);
 static void purgeProgram(Program* program);
-static opcode_t getOp(Program* program);
+static ProgramImage* programImageAcquire(const char* path);
+static void programImageRelease(ProgramImage* image);
+static void decodeInstruction(Program* program, int pos, ProgramInstruction* instruction);
+static ProgramInstruction* fetchInstruction(Program* program);
 static void checkProgramStrings(Program* program);
 static void op_noop(Program* program);
 static void op_const(Program* program);
@@ -164,6 +209,15 @@ static ProgramListNode* head;
 // 0x59E794
 static int suspendEvents;
 
+// Program images currently in use, see [programImageAcquire].
+static ProgramImage* programImages = NULL;
+
+// Number of program images read from files.
+static int programImagesLoaded = 0;
+
+// Number of [allocateProgram] calls served by an image already in use.
+static int programImagesShared = 0;
+
 // 0x45B400
 static unsigned int defaultTimerFunc()
 {
@@ -460,8 +514,12 @@ void interpretFreeProgram(Program* program)
         myfree(program->dynamicStrings, __FILE__, __LINE__); // "..\int\INTRPRET.C", 371
     }
 
-    if (program->data != NULL) {
-        myfree(program->data, __FILE__, __LINE__); // "..\int\INTRPRET.C", 372
+    if (program->procedures != NULL) {
+        myfree(program->procedures, __FILE__, __LINE__);
+    }
+
+    if (program->image != NULL) {
+        programImageRelease(program->image);
     }
 
     if (program->name != NULL) {
@@ -479,9 +537,22 @@ void interpretFreeProgram(Program* program)
     myfree(program, __FILE__, __LINE__); // "..\int\INTRPRET.C", 377
 }
 
-// 0x45BA44
-Program* allocateProgram(const char* path)
+// Returns image of program file at [path], reading it only if no other
+// program uses it.
+static ProgramImage* programImageAcquire(const char* path)
 {
+    unsigned int generation = db_generation();
+
+    ProgramImage* image = programImages;
+    while (image != NULL) {
+        if (image->generation == generation && stricmp(image->path, path) == 0) {
+            image->refCount++;
+            programImagesShared++;
+            return image;
+        }
+        image = image->next;
+    }
+
     DB_FILE* stream = db_fopen(path, "rb");
     if (stream == NULL) {
         char err[260];
@@ -496,6 +567,60 @@ Program* allocateProgram(const char* path)
     db_fread(data, 1, fileSize, stream);
     db_fclose(stream);
 
+    image = (ProgramImage*)mymalloc(sizeof(*image), __FILE__, __LINE__);
+    image->path = (char*)mymalloc(strlen(path) + 1, __FILE__, __LINE__);
+    strcpy(image->path, path);
+    image->data = data;
+    image->dataSize = fileSize;
+    image->instructionPagesLength = (fileSize / 2 + INSTRUCTION_PAGE_SIZE) / INSTRUCTION_PAGE_SIZE;
+    image->instructionPages = (ProgramInstruction**)mycalloc(image->instructionPagesLength, sizeof(*image->instructionPages), __FILE__, __LINE__);
+    image->refCount = 1;
+    image->generation = generation;
+    image->next = programImages;
+    programImages = image;
+
+    programImagesLoaded++;
+
+    return image;
+}
+
+// Drops reference to [image], freeing it when it was the last one.
+static void programImageRelease(ProgramImage* image)
+{
+    image->refCount--;
+    if (image->refCount > 0) {
+        return;
+    }
+
+    ProgramImage** link = &programImages;
+    while (*link != NULL) {
+        if (*link == image) {
+            *link = image->next;
+            break;
+        }
+        link = &((*link)->next);
+    }
+
+    for (int index = 0; index < image->instructionPagesLength; index++) {
+        if (image->instructionPages[index] != NULL) {
+            myfree(image->instructionPages[index], __FILE__, __LINE__);
+        }
+    }
+
+    myfree(image->instructionPages, __FILE__, __LINE__);
+    myfree(image->data, __FILE__, __LINE__);
+    myfree(image->path, __FILE__, __LINE__);
+    myfree(image, __FILE__, __LINE__);
+}
+
+// 0x45BA44
+Program* allocateProgram(const char* path)
+{
+    ProgramImage* image = programImageAcquire(path);
+    if (image == NULL) {
+        return NULL;
+    }
+
     Program* program = (Program*)mymalloc(sizeof(Program), __FILE__, __LINE__); // ..\int\INTRPRET.C, 402
     memset(program, 0, sizeof(Program));
 
@@ -510,24 +635,121 @@ Program* allocateProgram(const char* path)
     program->basePointer = -1;
     program->framePointer = -1;
     program->returnStack = (unsigned char*)mycalloc(1, STACK_SIZE, __FILE__, __LINE__); // ..\int\INTRPRET.C, 411
-    program->data = data;
-    program->procedures = data + 42;
-    program->identifiers = sizeof(Procedure) * fetchLong(program->procedures, 0) + program->procedures + 4;
+    program->image = image;
+    program->data = image->data;
+    program->dataSize = image->dataSize;
+
+    // Procedure table is the only part of the file programs write to. One
+    // entry past the end is copied as well, because [findCurrentProc] peeks
+    // at it to find where the last procedure ends.
+    unsigned char* procedures = image->data + 42;
+    int proceduresSize = 4 + sizeof(Procedure) * fetchLong(procedures, 0);
+    int copySize = proceduresSize + sizeof(Procedure);
+    if (copySize > image->dataSize - 42) {
+        copySize = image->dataSize - 42;
+    }
+
+    program->procedures = (unsigned char*)mycalloc(1, proceduresSize + sizeof(Procedure), __FILE__, __LINE__);
+    memcpy(program->procedures, procedures, copySize);
+    program->identifiers = procedures + proceduresSize;
     program->staticStrings = program->identifiers + fetchLong(program->identifiers, 0) + 4;
 
     return program;
 }
 
-// 0x45BC08
-static opcode_t getOp(Program* program)
+// Prints number of program images read from files and number of programs
+// which reused an image already in memory into [dest].
+bool interpretProgramImageStats(char* dest)
 {
-    int instructionPointer;
+    if (dest == NULL) {
+        return false;
+    }
 
-    instructionPointer = program->instructionPointer;
-    program->instructionPointer = instructionPointer + 2;
+    int count = 0;
+    int references = 0;
+    int pages = 0;
+    ProgramImage* image = programImages;
+    while (image != NULL) {
+        count++;
+        references += image->refCount;
+        for (int index = 0; index < image->instructionPagesLength; index++) {
+            if (image->instructionPages[index] != NULL) {
+                pages++;
+            }
+        }
+        image = image->next;
+    }
+
+    sprintf(dest, "Program images: %d loaded, %d shared, %d in use by %d programs, %d instruction pages decoded.\n", programImagesLoaded, programImagesShared, count, references, pages);
+
+    return true;
+}
+
+// Decodes instruction at [pos] into [instruction], validating opcode and
+// resolving its handler.
+static void decodeInstruction(Program* program, int pos, ProgramInstruction* instruction)
+{
+    char err[260];
 
     // NOTE: Uninline.
-    return fetchWord(program->data, instructionPointer);
+    opcode_t opcode = fetchWord(program->data, pos);
+
+    if (!((opcode >> 8) & 0x80)) {
+        sprintf(err, "Bad opcode %x %c %d.", opcode, opcode, opcode);
+        interpretError(err);
+    }
+
+    unsigned int opcodeIndex = opcode & 0x3FF;
+    OpcodeHandler* handler = opTable[opcodeIndex];
+    if (handler == NULL) {
+        sprintf(err, "Undefined opcode %x.", opcode);
+        interpretError(err);
+    }
+
+    instruction->opcode = opcode;
+    instruction->operand = 0;
+
+    // Constants truncated by the end of file are left to [op_const], which
+    // reads them the same way it always did.
+    if (handler == op_const && pos + 6 <= program->dataSize) {
+        instruction->operand = fetchLong(program->data, pos + 2);
+    }
+
+    instruction->handler = handler;
+}
+
+// Returns decoded instruction at instruction pointer and advances it past the
+// opcode (but not past the operands, which remain the handler's business).
+static ProgramInstruction* fetchInstruction(Program* program)
+{
+    static ProgramInstruction unaligned;
+
+    int instructionPointer = program->instructionPointer;
+    if (instructionPointer < 0 || instructionPointer + 2 > program->dataSize) {
+        interpretError("Instruction pointer %d out of range.", instructionPointer);
+    }
+
+    program->instructionPointer = instructionPointer + 2;
+
+    // Compiled scripts keep instructions 2-byte aligned, but nothing stops a
+    // jump from landing on an odd offset, so decode those every time.
+    if ((instructionPointer & 1) != 0) {
+        decodeInstruction(program, instructionPointer, &unaligned);
+        return &unaligned;
+    }
+
+    int slot = instructionPointer / 2;
+    ProgramInstruction** page = &(program->image->instructionPages[slot / INSTRUCTION_PAGE_SIZE]);
+    if (*page == NULL) {
+        *page = (ProgramInstruction*)mycalloc(INSTRUCTION_PAGE_SIZE, sizeof(**page), __FILE__, __LINE__);
+    }
+
+    ProgramInstruction* instruction = &((*page)[slot % INSTRUCTION_PAGE_SIZE]);
+    if (instruction->handler == NULL) {
+        decodeInstruction(program, instructionPointer, instruction);
+    }
+
+    return instruction;
 }
 
 // 0x45BC2C
@@ -2865,8 +3087,6 @@ void interpret(Program* program, int a2)
     // 0x59E798
     static int busy;
 
-    char err[260];
-
     Program* oldCurrentProgram = currentProgram;
 
     if (!enabled) {
@@ -2921,26 +3141,20 @@ void interpret(Program* program, int a2)
             program->flags &= ~PROGRAM_IS_WAITING;
         }
 
-        // NOTE: Uninline.
-        opcode_t opcode = getOp(program);
+        ProgramInstruction* instruction = fetchInstruction(program);
 
         // TODO: Replace with field_82 and field_80?
         program->flags &= 0xFFFF;
-        program->flags |= (opcode << 16);
-
-        if (!((opcode >> 8) & 0x80)) {
-            sprintf(err, "Bad opcode %x %c %d.", opcode, opcode, opcode);
-            interpretError(err);
-        }
+        program->flags |= (instruction->opcode << 16);
 
-        unsigned int opcodeIndex = opcode & 0x3FF;
-        OpcodeHandler* handler = opTable[opcodeIndex];
-        if (handler == NULL) {
-            sprintf(err, "Undefined opcode %x.", opcode);
-            interpretError(err);
+        if (instruction->handler == op_const && program->instructionPointer + 4 <= program->dataSize) {
+            // Inline [op_const] with pre-swapped operand.
+            program->instructionPointer += 4;
+            pushLongStack(program->stack, &(program->stackPointer), instruction->operand);
+            interpretPushShort(program, instruction->opcode);
+        } else {
+            instruction->handler(program);
         }
-
-        handler(program);
     }
 
     if ((program->flags & PROGRAM_FLAG_EXITED) != 0) {
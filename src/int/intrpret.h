@@ -132,6 +132,7 @@ typedef struct Procedure {
 } Procedure;
 
 typedef struct Program Program;
+typedef struct ProgramImage ProgramImage;
 typedef int(InterpretCheckWaitFunc)(Program* program);
 
 // It's size in original code is 144 (0x8C) bytes due to the different
@@ -160,6 +161,8 @@ typedef struct Program {
     int flags; // flags
     int windowId;
     bool exited;
+    int dataSize; // size of [data] in bytes
+    ProgramImage* image; // shared file contents [data] and decoded instructions belong to
 } Program;
 
 typedef char*(InterpretMangleFunc)(char* fileName);
@@ -178,6 +181,7 @@ opcode_t interpretPopShort(Program* program);
 int interpretPopLong(Program* program);
 void interpretFreeProgram(Program* program);
 Program* allocateProgram(const char* path);
+bool interpretProgramImageStats(char* dest);
 char* interpretGetString(Program* program, opcode_t opcode, int offset);
 char* interpretGetName(Program* program, int offset);
 int interpretAddString(Program* program, char* string);
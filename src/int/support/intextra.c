@@ -874,6 +874,7 @@ static void op_destroy_object(Program* program)
         if (isSelf) {
             object->sid = -1;
             object->flags |= (OBJECT_HIDDEN | OBJECT_TEMPORARY);
+            obj_blocking_changed(object);
         } else {
             register_clear(object);
             obj_erase_object(object, NULL);
@@ -2103,6 +2104,7 @@ static void objs_area_turn_on_off(int a1, int a2, int a3, int a4, int enabled)
                     } else {
                         object->flags |= OBJECT_HIDDEN;
                     }
+                    obj_blocking_changed(object);
                     rect_min_bound(&rect, &object_bounds, &rect);
                 }
             }
@@ -2190,6 +2192,7 @@ static void op_set_obj_visibility(Program* program)
             if (PID_TYPE(obj->pid) == OBJ_TYPE_CRITTER) {
                 obj->flags |= OBJECT_NO_BLOCK;
             }
+            obj_blocking_changed(obj);
 
             tile_refresh_rect(&rect, obj->elevation);
         }
@@ -2200,6 +2203,7 @@ static void op_set_obj_visibility(Program* program)
             }
 
             obj->flags &= ~OBJECT_HIDDEN;
+            obj_blocking_changed(obj);
 
             Rect rect;
             obj_bound(obj, &rect);
@@ -5139,6 +5143,7 @@ static void op_destroy_mult_objs(Program* program)
         if (isSelf) {
             object->sid = -1;
             object->flags |= (OBJECT_HIDDEN | OBJECT_TEMPORARY);
+            obj_blocking_changed(object);
         } else {
             register_clear(object);
             obj_erase_object(object, NULL);
@@ -82,6 +82,10 @@ Color colorMixAddTable[256][256];
 // 0x683B00
 Color intensityColorTable[256][256];
 
+// Incremented every time [intensityColorTable] is rebuilt, so that anything
+// derived from it can tell when it is out of date.
+unsigned int intensityColorTableVersion = 0;
+
 // 0x693B00
 Color colorMixMulTable[256][256];
 
@@ -333,6 +337,8 @@ static void setIntensityTables()
             memset(intensityColorTable[index], 0, 256);
         }
     }
+
+    intensityColorTableVersion++;
 }
 
 // 0x4C0248
@@ -487,6 +493,7 @@ bool loadColorTable(const char* path)
     if (type == 0x4E455743) {
         // NOTE: Uninline.
         colorRead(fd, intensityColorTable, 0x10000);
+        intensityColorTableVersion++;
 
         // NOTE: Uninline.
         colorRead(fd, colorMixAddTable, 0x10000);
@@ -1,5 +1,6 @@
 #include "plib/db/db.h"
 
+#include <ctype.h>
 #include <io.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -17,7 +18,30 @@
 
 #define DB_DATABASE_LIST_CAPACITY 10
 #define DB_DATABASE_FILE_LIST_CAPACITY 32
-#define DB_HASH_TABLE_SIZE 4095
+#define DB_HASH_TABLE_INITIAL_CAPACITY 1024
+#define DB_HASH_INITIAL_KEY 2166136261U
+
+// Maximum size of record [db_freadRecord] and [db_fwriteRecord] can handle,
+// also used as chunk size by bulk writers.
+#define DB_RECORD_BUFFER_SIZE 1024
+
+// Flag of [DB_FILE] denoting its buffer is borrowed from datafile mapping and
+// should not be freed.
+#define DB_FILE_FLAG_MAPPED 0x100
+
+// An entry of open-addressing table of patch file names.
+typedef struct DB_HASH_ENTRY {
+    unsigned int key;
+    char* name;
+} DB_HASH_ENTRY;
+
+// An entry of open-addressing table of DAT directory entries keyed by full
+// path (directory and file name).
+typedef struct DB_DIR_HASH_ENTRY {
+    unsigned int key;
+    int dir_index;
+    int entry_index;
+} DB_DIR_HASH_ENTRY;
 
 typedef struct DB_DATABASE DB_DATABASE;
 
@@ -46,7 +70,20 @@ typedef struct DB_DATABASE {
     assoc_array* entries;
     int files_length;
     DB_FILE files[DB_DATABASE_FILE_LIST_CAPACITY];
-    unsigned char* hash_table;
+
+    // Names of files in patches directory (and its subdirectories).
+    DB_HASH_ENTRY* hash_table;
+    int hash_table_capacity;
+    int hash_table_length;
+
+    // Index of [entries] by full path, see [db_init_dir_hash].
+    DB_DIR_HASH_ENTRY* dir_hash;
+    int dir_hash_capacity;
+
+    // Read-only view of entire datafile, see [db_map_datafile].
+    void* mapping;
+    unsigned char* mapped_data;
+    size_t mapped_size;
 } DB_DATABASE;
 
 typedef struct DB_FIND_DATA {
@@ -77,14 +114,24 @@ static int db_init_hash_table(DB_DATABASE* database);
 static int db_reset_hash_table(DB_DATABASE* database);
 static int db_fill_hash_table(DB_DATABASE* database, const char* path);
 static int db_add_hash_entry_to_database(DB_DATABASE* database, const char* path, int sep);
-static int db_set_hash_value(DB_DATABASE* database, unsigned int key, unsigned char enabled);
+static int db_set_hash_value(DB_DATABASE* database, unsigned int key, const char* name);
 static int db_get_hash_value(DB_DATABASE* database, const char* path, int sep, int* value_ptr);
 static int db_hash_string_to_key(const char* path, int sep, unsigned int* key_ptr);
+static const char* db_hash_path_filename(const char* path, int sep);
+static unsigned int db_hash_string(const char* string, size_t length, unsigned int key);
+static bool db_hash_name_equals(const char* name, const char* string, size_t length);
+static void db_clear_hash_table(DB_DATABASE* database);
 static void db_exit_hash_table(DB_DATABASE* database);
+static int db_init_dir_hash(DB_DATABASE* database);
+static int db_map_datafile(DB_DATABASE* database);
+static void db_unmap_datafile(DB_DATABASE* database);
+static int db_map_dir_entry(DB_DATABASE* database, const dir_entry* de, unsigned char** data_ptr);
+static void db_read_mapped_to_buf(const unsigned char* data, unsigned char* buf, size_t size);
+static int db_preload_mapped_buffer(DB_FILE* stream);
 static DB_FILE* db_add_fp_rec(FILE* stream, unsigned char* a2, int a3, int flags);
 static int db_delete_fp_rec(DB_FILE* stream);
 static int db_find_empty_position(int* position_ptr);
-static int db_find_dir_entry(char* path, dir_entry* de);
+static int db_find_dir_entry(const char* path, dir_entry* de);
 static int db_findfirst(const char* path, DB_FIND_DATA* find_data);
 static int db_findnext(DB_FIND_DATA* find_data);
 static int db_findclose(DB_FIND_DATA* find_data);
@@ -95,6 +142,12 @@ static void* db_default_malloc(size_t size);
 static char* db_default_strdup(const char* string);
 static void db_default_free(void* ptr);
 static void db_preload_buffer(DB_FILE* stream);
+static int db_record_size(const db_field* fields, int fields_length);
+static int db_fread_bytes(DB_FILE* stream, unsigned char* buf, int length);
+static unsigned short db_decode_short(const unsigned char* data);
+static int db_decode_int(const unsigned char* data);
+static void db_encode_short(unsigned char* data, unsigned short value);
+static void db_encode_int(unsigned char* data, int value);
 static int fread_short(FILE* stream, unsigned short* s);
 
 static inline bool fileFindIsDirectory(DB_FIND_DATA* find_data);
@@ -121,6 +174,12 @@ static db_free_func* db_free = db_default_free;
 // 0x539D48
 static bool hash_is_on = false;
 
+static bool mapping_is_on = false;
+
+// Incremented whenever set of files visible through databases might have
+// changed, see [db_generation].
+static unsigned int generation = 0;
+
 // NOTE: Original type is `unsigned long`.
 //
 // 0x539D4C
@@ -166,6 +225,8 @@ int db_init(const char* datafile, const char* datafile_path, const char* patches
         }
     }
 
+    generation++;
+
     return (int)database;
 }
 
@@ -234,6 +295,8 @@ int db_close(int db_handle)
             db_exit_hash_table(database_list[index]);
             db_destroy_database(&(database_list[index]));
 
+            generation++;
+
             return 0;
         }
     }
@@ -329,6 +392,43 @@ int db_dir_entry(const char* name, dir_entry* de)
     return 0;
 }
 
+// Obtains pointer to contents of stored (uncompressed) entry of current
+// datafile without copying it. The pointer is borrowed from datafile mapping
+// and remains valid until the database is closed.
+//
+// Returns -1 if the file is overridden in patches, is compressed, or
+// datafile is not mapped, in which case it should be read via [db_fopen].
+int db_map_entry(const char* name, const unsigned char** data_ptr, int* size_ptr)
+{
+    dir_entry de;
+    unsigned char* data;
+
+    if (data_ptr == NULL || size_ptr == NULL) {
+        return -1;
+    }
+
+    if (current_database == NULL || current_database->mapped_data == NULL) {
+        return -1;
+    }
+
+    if (db_dir_entry(name, &de) != 0) {
+        return -1;
+    }
+
+    if ((de.flags & 0x4) != 0 || (de.flags & 0xF0) != 32) {
+        return -1;
+    }
+
+    if (db_map_dir_entry(current_database, &de, &data) != 0) {
+        return -1;
+    }
+
+    *data_ptr = data;
+    *size_ptr = de.length;
+
+    return 0;
+}
+
 // 0x4AF4F8
 int db_read_to_buf(const char* filename, unsigned char* buf)
 {
@@ -344,6 +444,7 @@ int db_read_to_buf(const char* filename, unsigned char* buf)
     dir_entry de;
     char* end;
     unsigned short v4;
+    unsigned char* data;
 
     if (current_database == NULL) {
         return -1;
@@ -424,6 +525,23 @@ int db_read_to_buf(const char* filename, unsigned char* buf)
         return -1;
     }
 
+    if (de.flags == 0) {
+        de.flags = 16;
+    }
+
+    if (db_map_dir_entry(current_database, &de, &data) == 0) {
+        switch (de.flags & 0xF0) {
+        case 16:
+            lzss_decode_mem_to_buf(data, buf, de.field_C);
+            break;
+        case 32:
+            db_read_mapped_to_buf(data, buf, de.length);
+            break;
+        }
+
+        return 0;
+    }
+
     if (current_database->stream == NULL) {
         return -1;
     }
@@ -432,10 +550,6 @@ int db_read_to_buf(const char* filename, unsigned char* buf)
         return -1;
     }
 
-    if (de.flags == 0) {
-        de.flags = 16;
-    }
-
     switch (de.flags & 0xF0) {
     case 16:
         lzss_decode_to_buf(current_database->stream, buf, de.field_C);
@@ -521,6 +635,7 @@ DB_FILE* db_fopen(const char* filename, const char* mode)
     int k;
     dir_entry de;
     unsigned char* buf;
+    unsigned char* data;
 
     if (current_database == NULL) {
         return NULL;
@@ -615,6 +730,25 @@ DB_FILE* db_fopen(const char* filename, const char* mode)
         return NULL;
     }
 
+    if (de.flags == 0) {
+        de.flags = 16;
+    }
+
+    if (db_map_dir_entry(current_database, &de, &buf) == 0) {
+        switch (de.flags & 0xF0) {
+        case 16:
+            data = (unsigned char*)internal_malloc(de.length);
+            if (data != NULL) {
+                lzss_decode_mem_to_buf(buf, data, de.field_C);
+                return db_add_fp_rec(NULL, data, de.length, flags | 0x10 | 0x8);
+            }
+            return NULL;
+        case 32:
+            // Stored entries are read directly from mapping.
+            return db_add_fp_rec(NULL, buf, de.length, flags | 0x10 | 0x8 | DB_FILE_FLAG_MAPPED);
+        }
+    }
+
     if (current_database->stream == NULL) {
         return NULL;
     }
@@ -623,10 +757,6 @@ DB_FILE* db_fopen(const char* filename, const char* mode)
         return NULL;
     }
 
-    if (de.flags == 0) {
-        de.flags = 16;
-    }
-
     switch (de.flags & 0xF0) {
     case 16:
         buf = (unsigned char*)internal_malloc(de.length);
@@ -746,9 +876,8 @@ size_t db_fread(void* ptr, size_t size, size_t count, DB_FILE* stream)
                         if (elements_read != 0) {
                             if (fseek(stream->database->stream, stream->field_18, SEEK_SET) == 0) {
                                 if (read_callback != NULL) {
-                                    // FIXME: Probably error - mixing elements and
-                                    // bytes in `elements_read` without resetting.
                                     remaining_size = elements_read * size;
+                                    elements_read = 0;
                                     chunk_size = read_threshold - read_count;
 
                                     while (remaining_size >= chunk_size) {
@@ -769,7 +898,7 @@ size_t db_fread(void* ptr, size_t size, size_t count, DB_FILE* stream)
                                     }
 
                                     stream->field_18 = ftell(stream->database->stream);
-                                    stream->field_10 -= elements_read * size;
+                                    stream->field_10 -= elements_read;
 
                                     elements_read /= size;
                                 } else {
@@ -1198,20 +1327,13 @@ int db_freadByte(DB_FILE* stream, unsigned char* c)
 // 0x4B07C0
 int db_freadShort(DB_FILE* stream, unsigned short* s)
 {
-    unsigned char high;
-    unsigned char low;
-
-    // NOTE: Uninline.
-    if (db_freadByte(stream, &high) == -1) {
-        return -1;
-    }
+    unsigned char data[2];
 
-    // NOTE: Uninline.
-    if (db_freadByte(stream, &low) == -1) {
+    if (db_fread_bytes(stream, data, sizeof(data)) == -1) {
         return -1;
     }
 
-    *s = (high << 8) | low;
+    *s = db_decode_short(data);
 
     return 0;
 }
@@ -1219,18 +1341,13 @@ int db_freadShort(DB_FILE* stream, unsigned short* s)
 // 0x4B0820
 int db_freadInt(DB_FILE* stream, int* i)
 {
-    unsigned short high;
-    unsigned short low;
-
-    if (db_freadShort(stream, &high) == -1) {
-        return -1;
-    }
+    unsigned char data[4];
 
-    if (db_freadShort(stream, &low) == -1) {
+    if (db_fread_bytes(stream, data, sizeof(data)) == -1) {
         return -1;
     }
 
-    *i = (high << 16) | low;
+    *i = db_decode_int(data);
 
     return 0;
 }
@@ -1261,13 +1378,11 @@ int db_fwriteByte(DB_FILE* stream, unsigned char c)
 // 0x4B08A0
 int db_fwriteShort(DB_FILE* stream, unsigned short s)
 {
-    // NOTE: Uninline.
-    if (db_fwriteByte(stream, s >> 8) == -1) {
-        return -1;
-    }
+    unsigned char data[2];
 
-    // NOTE: Uninline.
-    if (db_fwriteByte(stream, s & 0xFF) == -1) {
+    db_encode_short(data, s);
+
+    if (db_fwrite(data, sizeof(data), 1, stream) != 1) {
         return -1;
     }
 
@@ -1277,11 +1392,11 @@ int db_fwriteShort(DB_FILE* stream, unsigned short s)
 // 0x4B08EC
 int db_fwriteInt(DB_FILE* stream, int i)
 {
-    if (db_fwriteShort(stream, i >> 16) == -1) {
-        return -1;
-    }
+    unsigned char data[4];
 
-    if (db_fwriteShort(stream, i & 0xFFFF) == -1) {
+    db_encode_int(data, i);
+
+    if (db_fwrite(data, sizeof(data), 1, stream) != 1) {
         return -1;
     }
 
@@ -1305,34 +1420,20 @@ int db_fwriteFloat(DB_FILE* stream, float q)
 // 0x4B09D4
 int db_freadByteCount(DB_FILE* stream, unsigned char* c, int count)
 {
-    int index;
-    unsigned char value;
-
-    for (index = 0; index < count; index++) {
-        // NOTE: Uninline.
-        if (db_freadByte(stream, &value) == -1) {
-            return -1;
-        }
-
-        c[index] = value;
-    }
-
-    return 0;
+    return db_fread_bytes(stream, c, count);
 }
 
 // 0x4B0A14
 int db_freadShortCount(DB_FILE* stream, unsigned short* s, int count)
 {
     int index;
-    unsigned short value;
 
-    for (index = 0; index < count; index++) {
-        // NOTE: Uninline.
-        if (db_freadShort(stream, &value) == -1) {
-            return -1;
-        }
+    if (db_fread_bytes(stream, (unsigned char*)s, sizeof(*s) * count) == -1) {
+        return -1;
+    }
 
-        s[index] = value;
+    for (index = 0; index < count; index++) {
+        s[index] = db_decode_short((unsigned char*)&(s[index]));
     }
 
     return 0;
@@ -1342,15 +1443,13 @@ int db_freadShortCount(DB_FILE* stream, unsigned short* s, int count)
 int db_freadIntCount(DB_FILE* stream, int* i, int count)
 {
     int index;
-    int value;
 
-    for (index = 0; index < count; index++) {
-        // NOTE: Uninline.
-        if (db_freadInt(stream, &value) == -1) {
-            return -1;
-        }
+    if (db_fread_bytes(stream, (unsigned char*)i, sizeof(*i) * count) == -1) {
+        return -1;
+    }
 
-        i[index] = value;
+    for (index = 0; index < count; index++) {
+        i[index] = db_decode_int((unsigned char*)&(i[index]));
     }
 
     return 0;
@@ -1359,114 +1458,253 @@ int db_freadIntCount(DB_FILE* stream, int* i, int count)
 // 0x4B0AB0
 int db_freadLongCount(DB_FILE* stream, unsigned long* l, int count)
 {
-    int index;
-    unsigned long value;
+    return db_freadIntCount(stream, (int*)l, count);
+}
 
-    for (index = 0; index < count; index++) {
-        // NOTE: Uninline.
-        if (db_freadLong(stream, &value) == -1) {
-            return -1;
-        }
+// 0x4B0AB0
+int db_freadFloatCount(DB_FILE* stream, float* q, int count)
+{
+    return db_freadIntCount(stream, (int*)q, count);
+}
 
-        l[index] = value;
+// 0x4B0B80
+int db_fwriteByteCount(DB_FILE* stream, unsigned char* c, int count)
+{
+    if (db_fwrite(c, 1, count, stream) != count) {
+        return -1;
     }
 
     return 0;
 }
 
-// 0x4B0AB0
-int db_freadFloatCount(DB_FILE* stream, float* q, int count)
+// 0x4B0BC8
+int db_fwriteShortCount(DB_FILE* stream, unsigned short* s, int count)
 {
+    unsigned char buffer[DB_RECORD_BUFFER_SIZE];
     int index;
-    float value;
+    int chunk;
 
-    for (index = 0; index < count; index++) {
-        // NOTE: Uninline.
-        if (db_freadFloat(stream, &value) == -1) {
+    while (count > 0) {
+        chunk = count < DB_RECORD_BUFFER_SIZE / 2 ? count : DB_RECORD_BUFFER_SIZE / 2;
+        for (index = 0; index < chunk; index++) {
+            db_encode_short(buffer + index * 2, s[index]);
+        }
+
+        if (db_fwrite(buffer, 2, chunk, stream) != chunk) {
             return -1;
         }
 
-        q[index] = value;
+        s += chunk;
+        count -= chunk;
     }
 
     return 0;
 }
 
-// 0x4B0B80
-int db_fwriteByteCount(DB_FILE* stream, unsigned char* c, int count)
+// 0x4B0C3C
+int db_fwriteIntCount(DB_FILE* stream, int* i, int count)
 {
+    unsigned char buffer[DB_RECORD_BUFFER_SIZE];
     int index;
+    int chunk;
 
-    for (index = 0; index < count; index++) {
-        // NOTE: Uninline.
-        if (db_fwriteByte(stream, c[index]) == -1) {
+    while (count > 0) {
+        chunk = count < DB_RECORD_BUFFER_SIZE / 4 ? count : DB_RECORD_BUFFER_SIZE / 4;
+        for (index = 0; index < chunk; index++) {
+            db_encode_int(buffer + index * 4, i[index]);
+        }
+
+        if (db_fwrite(buffer, 4, chunk, stream) != chunk) {
             return -1;
         }
+
+        i += chunk;
+        count -= chunk;
     }
 
     return 0;
 }
 
-// 0x4B0BC8
-int db_fwriteShortCount(DB_FILE* stream, unsigned short* s, int count)
+// 0x4B0C9C
+int db_fwriteLongCount(DB_FILE* stream, unsigned long* l, int count)
 {
+    return db_fwriteIntCount(stream, (int*)l, count);
+}
+
+// 0x4B0D54
+int db_fwriteFloatCount(DB_FILE* stream, float* q, int count)
+{
+    return db_fwriteIntCount(stream, (int*)q, count);
+}
+
+// Reads record described by [fields] (see [db_field]) from [stream] into
+// [record] with a single read, converting fields from big-endian.
+int db_freadRecord(DB_FILE* stream, void* record, const db_field* fields, int fields_length)
+{
+    unsigned char buffer[DB_RECORD_BUFFER_SIZE];
+    unsigned char* data;
+    unsigned char* dest;
+    int size;
     int index;
+    int value_index;
 
-    for (index = 0; index < count; index++) {
-        // NOTE: Uninline.
-        if (db_fwriteShort(stream, s[index]) == -1) {
-            return -1;
+    size = db_record_size(fields, fields_length);
+    if (size > DB_RECORD_BUFFER_SIZE) {
+        return -1;
+    }
+
+    if (db_fread_bytes(stream, buffer, size) == -1) {
+        return -1;
+    }
+
+    data = buffer;
+    for (index = 0; index < fields_length; index++) {
+        if (fields[index].offset == DB_FIELD_SKIP) {
+            data += fields[index].size * fields[index].count;
+            continue;
+        }
+
+        dest = (unsigned char*)record + fields[index].offset;
+        for (value_index = 0; value_index < fields[index].count; value_index++) {
+            switch (fields[index].size) {
+            case 1:
+                *dest = *data;
+                break;
+            case 2:
+                *(unsigned short*)dest = db_decode_short(data);
+                break;
+            case 4:
+                *(int*)dest = db_decode_int(data);
+                break;
+            }
+
+            dest += fields[index].size;
+            data += fields[index].size;
         }
     }
 
     return 0;
 }
 
-// 0x4B0C3C
-int db_fwriteIntCount(DB_FILE* stream, int* i, int count)
+// Writes [record] described by [fields] to [stream] in big-endian with a
+// single write. Skipped fields are written as zeroes.
+int db_fwriteRecord(DB_FILE* stream, const void* record, const db_field* fields, int fields_length)
 {
+    unsigned char buffer[DB_RECORD_BUFFER_SIZE];
+    unsigned char* data;
+    const unsigned char* src;
+    int size;
     int index;
+    int value_index;
 
-    for (index = 0; index < count; index++) {
-        // NOTE: Uninline.
-        if (db_fwriteInt(stream, i[index]) == -1) {
-            return -1;
+    size = db_record_size(fields, fields_length);
+    if (size > DB_RECORD_BUFFER_SIZE) {
+        return -1;
+    }
+
+    data = buffer;
+    for (index = 0; index < fields_length; index++) {
+        if (fields[index].offset == DB_FIELD_SKIP) {
+            memset(data, 0, fields[index].size * fields[index].count);
+            data += fields[index].size * fields[index].count;
+            continue;
+        }
+
+        src = (const unsigned char*)record + fields[index].offset;
+        for (value_index = 0; value_index < fields[index].count; value_index++) {
+            switch (fields[index].size) {
+            case 1:
+                *data = *src;
+                break;
+            case 2:
+                db_encode_short(data, *(const unsigned short*)src);
+                break;
+            case 4:
+                db_encode_int(data, *(const int*)src);
+                break;
+            }
+
+            src += fields[index].size;
+            data += fields[index].size;
         }
     }
 
+    if (db_fwrite(buffer, 1, size, stream) != size) {
+        return -1;
+    }
+
     return 0;
 }
 
-// 0x4B0C9C
-int db_fwriteLongCount(DB_FILE* stream, unsigned long* l, int count)
+// Returns number of bytes record described by [fields] occupies in file.
+static int db_record_size(const db_field* fields, int fields_length)
 {
+    int size;
     int index;
 
-    for (index = 0; index < count; index++) {
-        // NOTE: Uninline.
-        if (db_fwriteLong(stream, l[index]) == -1) {
-            return -1;
-        }
+    size = 0;
+    for (index = 0; index < fields_length; index++) {
+        size += fields[index].size * fields[index].count;
     }
 
-    return 0;
+    return size;
 }
 
-// 0x4B0D54
-int db_fwriteFloatCount(DB_FILE* stream, float* q, int count)
+// Reads [length] bytes from [stream] into [buf]. Binary streams are read in
+// one go, text streams need line endings translated and go byte by byte.
+static int db_fread_bytes(DB_FILE* stream, unsigned char* buf, int length)
 {
     int index;
+    int ch;
 
-    for (index = 0; index < count; index++) {
-        // NOTE: Uninline.
-        if (db_fwriteFloat(stream, q[index]) == -1) {
+    if (stream == NULL) {
+        return -1;
+    }
+
+    if ((stream->flags & 0x2) == 0) {
+        if (db_fread(buf, 1, length, stream) != length) {
+            return -1;
+        }
+
+        return 0;
+    }
+
+    for (index = 0; index < length; index++) {
+        ch = db_fgetc(stream);
+        if (ch == -1) {
             return -1;
         }
+
+        buf[index] = ch & 0xFF;
     }
 
     return 0;
 }
 
+static unsigned short db_decode_short(const unsigned char* data)
+{
+    return (data[0] << 8) | data[1];
+}
+
+static int db_decode_int(const unsigned char* data)
+{
+    return (int)(((unsigned int)data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3]);
+}
+
+static void db_encode_short(unsigned char* data, unsigned short value)
+{
+    data[0] = (value >> 8) & 0xFF;
+    data[1] = value & 0xFF;
+}
+
+static void db_encode_int(unsigned char* data, int value)
+{
+    data[0] = (value >> 24) & 0xFF;
+    data[1] = (value >> 16) & 0xFF;
+    data[2] = (value >> 8) & 0xFF;
+    data[3] = value & 0xFF;
+}
+
 // 0x4B0D94
 static int db_read_long(FILE* stream, unsigned long* value_ptr)
 {
@@ -1914,7 +2152,13 @@ static int db_init_database(DB_DATABASE* database, const char* datafile, const c
         return -1;
     }
 
+    if (mapping_is_on) {
+        // Failure is not critical, entries will be read via [stream].
+        db_map_datafile(database);
+    }
+
     if (assoc_init(&(database->root), 0, sizeof(*database->entries), NULL) != 0) {
+        db_unmap_datafile(database);
         fclose(database->stream);
         internal_free(database->datafile);
         database->datafile = NULL;
@@ -1922,6 +2166,7 @@ static int db_init_database(DB_DATABASE* database, const char* datafile, const c
     }
 
     if (assoc_load(database->stream, &(database->root), 0) != 0) {
+        db_unmap_datafile(database);
         fclose(database->stream);
         internal_free(database->datafile);
         database->datafile = NULL;
@@ -1931,6 +2176,7 @@ static int db_init_database(DB_DATABASE* database, const char* datafile, const c
     database->entries = (assoc_array*)internal_malloc(sizeof(*database->entries) * database->root.size);
     if (database->entries == NULL) {
         assoc_free(&(database->root));
+        db_unmap_datafile(database);
         fclose(database->stream);
         internal_free(database->datafile);
         database->datafile = NULL;
@@ -1959,6 +2205,21 @@ static int db_init_database(DB_DATABASE* database, const char* datafile, const c
 
         internal_free(database->entries);
         assoc_free(&(database->root));
+        db_unmap_datafile(database);
+        fclose(database->stream);
+        internal_free(database->datafile);
+        database->datafile = NULL;
+        return -1;
+    }
+
+    if (db_init_dir_hash(database) != 0) {
+        for (index = 0; index < database->root.size; index++) {
+            assoc_free(&(database->entries[index]));
+        }
+
+        internal_free(database->entries);
+        assoc_free(&(database->root));
+        db_unmap_datafile(database);
         fclose(database->stream);
         internal_free(database->datafile);
         database->datafile = NULL;
@@ -1977,8 +2238,11 @@ static int db_init_database(DB_DATABASE* database, const char* datafile, const c
     v2 = strlen(v1);
     database->datafile_path = internal_malloc(v2 + 2);
     if (database->datafile_path == NULL) {
+        internal_free(database->dir_hash);
+        database->dir_hash = NULL;
         internal_free(database->entries);
         assoc_free(&(database->root));
+        db_unmap_datafile(database);
         fclose(database->stream);
         internal_free(database->datafile);
         database->datafile = NULL;
@@ -2004,6 +2268,8 @@ static void db_exit_database(DB_DATABASE* database)
         return;
     }
 
+    db_unmap_datafile(database);
+
     if (database->stream != NULL) {
         fclose(database->stream);
         database->stream = NULL;
@@ -2022,6 +2288,12 @@ static void db_exit_database(DB_DATABASE* database)
         database->entries = NULL;
     }
 
+    if (database->dir_hash != NULL) {
+        internal_free(database->dir_hash);
+        database->dir_hash = NULL;
+        database->dir_hash_capacity = 0;
+    }
+
     assoc_free(&(database->root));
 
     if (database->datafile_path != NULL) {
@@ -2094,11 +2366,15 @@ static int db_init_hash_table(DB_DATABASE* database)
         return -1;
     }
 
-    database->hash_table = (unsigned char*)internal_malloc(DB_HASH_TABLE_SIZE);
+    database->hash_table = (DB_HASH_ENTRY*)internal_malloc(sizeof(*database->hash_table) * DB_HASH_TABLE_INITIAL_CAPACITY);
     if (database->hash_table == NULL) {
         return -1;
     }
 
+    memset(database->hash_table, 0, sizeof(*database->hash_table) * DB_HASH_TABLE_INITIAL_CAPACITY);
+    database->hash_table_capacity = DB_HASH_TABLE_INITIAL_CAPACITY;
+    database->hash_table_length = 0;
+
     return db_reset_hash_table(database);
 }
 
@@ -2106,6 +2382,13 @@ static int db_init_hash_table(DB_DATABASE* database)
 void db_enable_hash_table()
 {
     hash_is_on = true;
+    generation++;
+}
+
+// Enables mapping of datafiles opened afterwards into memory.
+void db_enable_mapping()
+{
+    mapping_is_on = true;
 }
 
 // 0x4B1F9C
@@ -2124,13 +2407,17 @@ static int db_reset_hash_table(DB_DATABASE* database)
     }
 
     if (database->hash_table == NULL) {
-        database->hash_table = (unsigned char*)internal_malloc(DB_HASH_TABLE_SIZE);
+        database->hash_table = (DB_HASH_ENTRY*)internal_malloc(sizeof(*database->hash_table) * DB_HASH_TABLE_INITIAL_CAPACITY);
         if (database->hash_table == NULL) {
             return -1;
         }
+
+        memset(database->hash_table, 0, sizeof(*database->hash_table) * DB_HASH_TABLE_INITIAL_CAPACITY);
+        database->hash_table_capacity = DB_HASH_TABLE_INITIAL_CAPACITY;
+        database->hash_table_length = 0;
     }
 
-    memset(database->hash_table, 0, DB_HASH_TABLE_SIZE);
+    db_clear_hash_table(database);
 
     return db_fill_hash_table(database, database->patches_path);
 }
@@ -2199,6 +2486,8 @@ int db_reset_hash_tables()
         }
     }
 
+    generation++;
+
     return 0;
 }
 
@@ -2221,9 +2510,19 @@ int db_add_hash_entry(const char* path, int sep)
         return -1;
     }
 
+    generation++;
+
     return db_add_hash_entry_to_database(current_database, path, sep);
 }
 
+// Returns a counter which changes whenever databases are opened or closed,
+// or their patch file tables are rebuilt or extended. Clients memoizing
+// results of [db_dir_entry] should discard them when it changes.
+unsigned int db_generation()
+{
+    return generation;
+}
+
 // 0x4B21E0
 static int db_add_hash_entry_to_database(DB_DATABASE* database, const char* path, int sep)
 {
@@ -2245,12 +2544,22 @@ static int db_add_hash_entry_to_database(DB_DATABASE* database, const char* path
         return -1;
     }
 
-    return db_set_hash_value(database, key, 1);
+    return db_set_hash_value(database, key, db_hash_path_filename(path, sep));
 }
 
+// Adds file [name] with precomputed [key] to the table of patch file names,
+// growing it when it becomes half full.
+//
 // 0x4B2258
-static int db_set_hash_value(DB_DATABASE* database, unsigned int key, unsigned char enabled)
+static int db_set_hash_value(DB_DATABASE* database, unsigned int key, const char* name)
 {
+    DB_HASH_ENTRY* entry;
+    DB_HASH_ENTRY* table;
+    int capacity;
+    int mask;
+    int index;
+    int slot;
+
     if (!hash_is_on) {
         return -1;
     }
@@ -2259,23 +2568,70 @@ static int db_set_hash_value(DB_DATABASE* database, unsigned int key, unsigned c
         return -1;
     }
 
-    if (key >= 0x7FFF) {
-        return -1;
+    mask = database->hash_table_capacity - 1;
+    for (slot = key & mask;; slot = (slot + 1) & mask) {
+        entry = &(database->hash_table[slot]);
+        if (entry->name == NULL) {
+            break;
+        }
+
+        if (entry->key == key && stricmp(entry->name, name) == 0) {
+            return 0;
+        }
     }
 
-    if (enabled == true) {
-        database->hash_table[key / 8] |= 1 << (key % 8);
-    } else {
-        database->hash_table[key / 8] = 0;
+    if ((database->hash_table_length + 1) * 2 > database->hash_table_capacity) {
+        capacity = database->hash_table_capacity * 2;
+        table = (DB_HASH_ENTRY*)internal_malloc(sizeof(*table) * capacity);
+        if (table == NULL) {
+            return -1;
+        }
+
+        memset(table, 0, sizeof(*table) * capacity);
+
+        mask = capacity - 1;
+        for (index = 0; index < database->hash_table_capacity; index++) {
+            if (database->hash_table[index].name != NULL) {
+                slot = database->hash_table[index].key & mask;
+                while (table[slot].name != NULL) {
+                    slot = (slot + 1) & mask;
+                }
+                table[slot] = database->hash_table[index];
+            }
+        }
+
+        internal_free(database->hash_table);
+        database->hash_table = table;
+        database->hash_table_capacity = capacity;
+
+        slot = key & mask;
+        while (table[slot].name != NULL) {
+            slot = (slot + 1) & mask;
+        }
+        entry = &(table[slot]);
+    }
+
+    entry->name = internal_strdup(name);
+    if (entry->name == NULL) {
+        return -1;
     }
 
+    entry->key = key;
+    database->hash_table_length++;
+
     return 0;
 }
 
+// Sets [value_ptr] to 1 if there is a file with the same name as in [path]
+// in patches directory, or 0 otherwise.
+//
 // 0x4B2304
 static int db_get_hash_value(DB_DATABASE* database, const char* path, int sep, int* value_ptr)
 {
     unsigned int key;
+    const char* name;
+    int mask;
+    int slot;
 
     if (!hash_is_on) {
         return -1;
@@ -2293,59 +2649,291 @@ static int db_get_hash_value(DB_DATABASE* database, const char* path, int sep, i
         return -1;
     }
 
-    if (key >= 0x7FFF) {
-        return -1;
-    }
+    name = db_hash_path_filename(path, sep);
+
+    *value_ptr = 0;
 
-    *value_ptr = (database->hash_table[key / 8] >> (key % 8)) & 1;
+    mask = database->hash_table_capacity - 1;
+    for (slot = key & mask; database->hash_table[slot].name != NULL; slot = (slot + 1) & mask) {
+        if (database->hash_table[slot].key == key && stricmp(database->hash_table[slot].name, name) == 0) {
+            *value_ptr = 1;
+            break;
+        }
+    }
 
     return 0;
 }
 
+// Calculates case-insensitive key of file name component of [path].
+//
 // 0x4B2394
 static int db_hash_string_to_key(const char* path, int sep, unsigned int* key_ptr)
 {
-    char* copy;
-    char* pch;
-    char* filename;
-    size_t index;
-    unsigned int key;
-
-    key = 1;
+    const char* filename;
 
     if (path == NULL) {
         return -1;
     }
 
-    copy = (char*)internal_strdup(path);
-    strupr(copy);
+    filename = db_hash_path_filename(path, sep);
+    *key_ptr = db_hash_string(filename, strlen(filename), DB_HASH_INITIAL_KEY);
 
-    pch = strrchr(copy, sep);
+    return 0;
+}
+
+// Returns file name component of [path].
+static const char* db_hash_path_filename(const char* path, int sep)
+{
+    const char* pch;
+
+    pch = strrchr(path, sep);
     if (pch != NULL) {
-        filename = pch + 1;
-    } else {
-        filename = copy;
+        return pch + 1;
+    }
+
+    return path;
+}
+
+// Continues case-insensitive FNV-1a hash [key] with [length] characters of
+// [string].
+static unsigned int db_hash_string(const char* string, size_t length, unsigned int key)
+{
+    size_t index;
+
+    for (index = 0; index < length; index++) {
+        key ^= (unsigned char)toupper((unsigned char)string[index]);
+        key *= 16777619U;
     }
 
-    for (index = 0; index < strlen(filename); index++) {
-        key *= *filename++;
-        key &= 0x7FFFFFFF;
+    return key;
+}
+
+// Returns `true` if [name] is case-insensitive equal to [length] characters
+// of [string].
+static bool db_hash_name_equals(const char* name, const char* string, size_t length)
+{
+    size_t index;
+
+    for (index = 0; index < length; index++) {
+        if (name[index] == '\0') {
+            return false;
+        }
+
+        if (toupper((unsigned char)name[index]) != toupper((unsigned char)string[index])) {
+            return false;
+        }
     }
 
-    *key_ptr = key & 0x7FFF;
+    return name[length] == '\0';
+}
 
-    internal_free(copy);
+// Removes all names from the table of patch file names.
+static void db_clear_hash_table(DB_DATABASE* database)
+{
+    int index;
 
-    return 0;
+    for (index = 0; index < database->hash_table_capacity; index++) {
+        if (database->hash_table[index].name != NULL) {
+            internal_free(database->hash_table[index].name);
+            database->hash_table[index].name = NULL;
+        }
+    }
+
+    database->hash_table_length = 0;
 }
 
 // 0x4B2420
 static void db_exit_hash_table(DB_DATABASE* database)
 {
     if (database->hash_table != NULL) {
+        db_clear_hash_table(database);
         internal_free(database->hash_table);
     }
     database->hash_table = NULL;
+    database->hash_table_capacity = 0;
+}
+
+// Builds index of all entries of DAT file by their full path
+// (`DIRECTORY\FILENAME`), see [db_find_dir_entry].
+static int db_init_dir_hash(DB_DATABASE* database)
+{
+    DB_DIR_HASH_ENTRY* entry;
+    const char* dir_name;
+    const char* name;
+    unsigned int key;
+    int count;
+    int capacity;
+    int dir_index;
+    int entry_index;
+    int slot;
+
+    count = 0;
+    for (dir_index = 0; dir_index < database->root.size; dir_index++) {
+        count += database->entries[dir_index].size;
+    }
+
+    capacity = 16;
+    while (capacity < count * 2) {
+        capacity *= 2;
+    }
+
+    database->dir_hash = (DB_DIR_HASH_ENTRY*)internal_malloc(sizeof(*database->dir_hash) * capacity);
+    if (database->dir_hash == NULL) {
+        return -1;
+    }
+
+    for (slot = 0; slot < capacity; slot++) {
+        database->dir_hash[slot].dir_index = -1;
+    }
+
+    database->dir_hash_capacity = capacity;
+
+    for (dir_index = 0; dir_index < database->root.size; dir_index++) {
+        dir_name = database->root.list[dir_index].name;
+        for (entry_index = 0; entry_index < database->entries[dir_index].size; entry_index++) {
+            name = database->entries[dir_index].list[entry_index].name;
+
+            key = db_hash_string(dir_name, strlen(dir_name), DB_HASH_INITIAL_KEY);
+            key = db_hash_string("\\", 1, key);
+            key = db_hash_string(name, strlen(name), key);
+
+            slot = key & (capacity - 1);
+            while (database->dir_hash[slot].dir_index != -1) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+
+            entry = &(database->dir_hash[slot]);
+            entry->key = key;
+            entry->dir_index = dir_index;
+            entry->entry_index = entry_index;
+        }
+    }
+
+    return 0;
+}
+
+// Maps entire datafile into memory so that entries can be served without
+// seeking and reading shared [stream].
+static int db_map_datafile(DB_DATABASE* database)
+{
+#if defined(__WATCOMC__)
+    return -1;
+#elif defined(_WIN32)
+    HANDLE file;
+    HANDLE mapping;
+    DWORD size;
+    void* data;
+
+    file = CreateFileA(database->datafile, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return -1;
+    }
+
+    size = GetFileSize(file, NULL);
+    if (size == INVALID_FILE_SIZE || size == 0) {
+        CloseHandle(file);
+        return -1;
+    }
+
+    // Mapping keeps its own reference to the file.
+    mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+
+    if (mapping == NULL) {
+        return -1;
+    }
+
+    data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == NULL) {
+        CloseHandle(mapping);
+        return -1;
+    }
+
+    database->mapping = mapping;
+    database->mapped_data = (unsigned char*)data;
+    database->mapped_size = size;
+
+    return 0;
+#else
+#error Not implemented
+#endif
+}
+
+static void db_unmap_datafile(DB_DATABASE* database)
+{
+    if (database->mapped_data == NULL) {
+        return;
+    }
+
+#if defined(_WIN32) && !defined(__WATCOMC__)
+    UnmapViewOfFile(database->mapped_data);
+    CloseHandle((HANDLE)database->mapping);
+#endif
+
+    database->mapping = NULL;
+    database->mapped_data = NULL;
+    database->mapped_size = 0;
+}
+
+// Obtains pointer to data of LZSS-compressed (16) or stored (32) entry
+// within datafile mapping. Chunked entries (64) are mapped chunk by chunk in
+// [db_preload_buffer].
+static int db_map_dir_entry(DB_DATABASE* database, const dir_entry* de, unsigned char** data_ptr)
+{
+    size_t size;
+
+    if (database->mapped_data == NULL) {
+        return -1;
+    }
+
+    switch (de->flags & 0xF0) {
+    case 16:
+        size = de->field_C;
+        break;
+    case 32:
+        size = de->length;
+        break;
+    default:
+        return -1;
+    }
+
+    if (de->offset < 0 || (size_t)de->offset > database->mapped_size || size > database->mapped_size - de->offset) {
+        return -1;
+    }
+
+    *data_ptr = database->mapped_data + de->offset;
+
+    return 0;
+}
+
+// Copies [size] bytes from datafile mapping notifying [read_callback] in the
+// same manner as stream reads do.
+static void db_read_mapped_to_buf(const unsigned char* data, unsigned char* buf, size_t size)
+{
+    size_t chunk_size;
+
+    if (read_callback != NULL) {
+        chunk_size = read_threshold - read_count;
+
+        while (size >= chunk_size) {
+            memcpy(buf, data, chunk_size);
+            buf += chunk_size;
+            data += chunk_size;
+            size -= chunk_size;
+
+            read_count = 0;
+            read_callback();
+
+            chunk_size = read_threshold;
+        }
+
+        if (size != 0) {
+            memcpy(buf, data, size);
+            read_count += size;
+        }
+    } else {
+        memcpy(buf, data, size);
+    }
 }
 
 // 0x4B2444
@@ -2411,7 +2999,7 @@ static int db_delete_fp_rec(DB_FILE* stream)
     } else {
         switch (stream->flags & 0xF0) {
         case 16:
-            if (stream->field_1C != NULL) {
+            if (stream->field_1C != NULL && (stream->flags & DB_FILE_FLAG_MAPPED) == 0) {
                 internal_free(stream->field_1C);
             }
             break;
@@ -2455,12 +3043,16 @@ static int db_find_empty_position(int* position_ptr)
 }
 
 // 0x4B2714
-static int db_find_dir_entry(char* path, dir_entry* de)
+static int db_find_dir_entry(const char* path, dir_entry* de)
 {
-    char* normalized_path;
-    int pos;
-    int dir_index;
-    int entry_index;
+    const char* normalized_path;
+    const char* dir_name;
+    size_t dir_name_length;
+    const char* filename;
+    unsigned int key;
+    int mask;
+    int slot;
+    DB_DIR_HASH_ENTRY* entry;
 
     normalized_path = path;
 
@@ -2476,6 +3068,10 @@ static int db_find_dir_entry(char* path, dir_entry* de)
         return -1;
     }
 
+    if (current_database->dir_hash == NULL) {
+        return -1;
+    }
+
     if (path[0] == '.') {
         normalized_path = path + 1;
         if (path[1] == '\\') {
@@ -2483,43 +3079,38 @@ static int db_find_dir_entry(char* path, dir_entry* de)
         }
     }
 
-    pos = strlen(normalized_path) - 1;
-    while (pos >= 0) {
-        if (normalized_path[pos] == '\\') {
-            break;
+    filename = strrchr(normalized_path, '\\');
+    if (filename != NULL) {
+        dir_name = normalized_path;
+        dir_name_length = filename - normalized_path;
+        filename++;
+    } else {
+        // Files without directory are looked up in the first directory.
+        if (current_database->root.size == 0) {
+            return -1;
         }
-        pos--;
-    }
 
-    if (pos >= 0) {
-        normalized_path[pos] = '\0';
-        dir_index = assoc_search(&(current_database->root), normalized_path);
-    } else {
-        dir_index = 0;
+        dir_name = current_database->root.list[0].name;
+        dir_name_length = strlen(dir_name);
+        filename = normalized_path;
     }
 
-    if (dir_index == -1) {
-        if (pos >= 0) {
-            normalized_path[pos] = '\\';
-        }
-        return -1;
-    }
+    key = db_hash_string(dir_name, dir_name_length, DB_HASH_INITIAL_KEY);
+    key = db_hash_string("\\", 1, key);
+    key = db_hash_string(filename, strlen(filename), key);
 
-    entry_index = assoc_search(&(current_database->entries[dir_index]), normalized_path + pos + 1);
-    if (entry_index == -1) {
-        if (pos >= 0) {
-            normalized_path[pos] = '\\';
+    mask = current_database->dir_hash_capacity - 1;
+    for (slot = key & mask; current_database->dir_hash[slot].dir_index != -1; slot = (slot + 1) & mask) {
+        entry = &(current_database->dir_hash[slot]);
+        if (entry->key == key
+            && db_hash_name_equals(current_database->root.list[entry->dir_index].name, dir_name, dir_name_length)
+            && stricmp(current_database->entries[entry->dir_index].list[entry->entry_index].name, filename) == 0) {
+            *de = *((dir_entry*)current_database->entries[entry->dir_index].list[entry->entry_index].data);
+            return 0;
         }
-        return -1;
     }
 
-    if (pos >= 0) {
-        normalized_path[pos] = '\\';
-    }
-
-    *de = *((dir_entry*)current_database->entries[dir_index].list[entry_index].data);
-
-    return 0;
+    return -1;
 }
 
 // 0x4B2810
@@ -2631,6 +3222,10 @@ static void db_preload_buffer(DB_FILE* stream)
     if ((stream->flags & 0x8) != 0 && (stream->flags & 0xF0) == 64) {
         if (stream->field_10 != 0) {
             if (stream->field_20 >= stream->field_1C + 0x4000) {
+                if (db_preload_mapped_buffer(stream) == 0) {
+                    return;
+                }
+
                 if (fseek(stream->database->stream, stream->field_18, SEEK_SET) == 0) {
                     if (fread_short(stream->database->stream, &v1) == 0) {
                         if ((v1 & 0x8000) != 0) {
@@ -2649,6 +3244,42 @@ static void db_preload_buffer(DB_FILE* stream)
     }
 }
 
+// Loads next chunk of chunked entry (64) from datafile mapping.
+static int db_preload_mapped_buffer(DB_FILE* stream)
+{
+    DB_DATABASE* database;
+    const unsigned char* data;
+    unsigned short v1;
+
+    database = stream->database;
+    if (database->mapped_data == NULL) {
+        return -1;
+    }
+
+    if (stream->field_18 < 0 || (size_t)stream->field_18 + 2 > database->mapped_size) {
+        return -1;
+    }
+
+    data = database->mapped_data + stream->field_18;
+    v1 = (data[0] << 8) | data[1];
+
+    if ((size_t)stream->field_18 + 2 + (v1 & ~0x8000) > database->mapped_size) {
+        return -1;
+    }
+
+    if ((v1 & 0x8000) != 0) {
+        v1 &= ~0x8000;
+        memcpy(stream->field_1C, data + 2, v1);
+    } else {
+        lzss_decode_mem_to_buf(data + 2, stream->field_1C, v1);
+    }
+
+    stream->field_20 = stream->field_1C;
+    stream->field_18 += 2 + v1;
+
+    return 0;
+}
+
 // 0x4B2970
 static int fread_short(FILE* stream, unsigned short* s)
 {
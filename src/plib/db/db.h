@@ -13,6 +13,17 @@ typedef struct dir_entry_s {
     int field_C;
 } dir_entry;
 
+// Describes [count] consecutive big-endian values of [size] bytes each (1, 2
+// or 4) stored at [offset] in a record, see [db_freadRecord].
+typedef struct db_field_s {
+    int size;
+    int count;
+    int offset;
+} db_field;
+
+// Offset of [db_field] present in file but not in record.
+#define DB_FIELD_SKIP -1
+
 typedef void db_read_callback();
 typedef void*(db_malloc_func)(size_t size);
 typedef char*(db_strdup_func)(const char* string);
@@ -25,6 +36,7 @@ int db_total();
 int db_close(int db_handle);
 void db_exit();
 int db_dir_entry(const char* filePath, dir_entry* de);
+int db_map_entry(const char* name, const unsigned char** data_ptr, int* size_ptr);
 int db_read_to_buf(const char* filePath, unsigned char* ptr);
 DB_FILE* db_fopen(const char* filename, const char* mode);
 int db_fclose(DB_FILE* stream);
@@ -58,6 +70,8 @@ int db_fwriteShortCount(DB_FILE* stream, unsigned short* s, int count);
 int db_fwriteIntCount(DB_FILE* stream, int* i, int count);
 int db_fwriteLongCount(DB_FILE* stream, unsigned long* l, int count);
 int db_fwriteFloatCount(DB_FILE* stream, float* q, int count);
+int db_freadRecord(DB_FILE* stream, void* record, const db_field* fields, int fields_length);
+int db_fwriteRecord(DB_FILE* stream, const void* record, const db_field* fields, int fields_length);
 int db_fprintf(DB_FILE* stream, const char* format, ...);
 int db_feof(DB_FILE* stream);
 int db_get_file_list(const char* filespec, char*** filelist, char*** desclist, int desclen);
@@ -66,7 +80,9 @@ long db_filelength(DB_FILE* stream);
 void db_register_mem(db_malloc_func* malloc_func, db_strdup_func* strdup_func, db_free_func* free_func);
 void db_register_callback(db_read_callback* callback, size_t threshold);
 void db_enable_hash_table();
+void db_enable_mapping();
 int db_reset_hash_tables();
 int db_add_hash_entry(const char* path, int sep);
+unsigned int db_generation();
 
 #endif /* FALLOUT_PLIB_DB_DB_H_ */
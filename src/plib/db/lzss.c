@@ -7,8 +7,22 @@
 
 #include "plib/db/lzss.h"
 
+#include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
 
+// Size of sliding window.
+#define LZSS_WINDOW_SIZE 4096
+
+// Initial position in sliding window, everything before it is filled with
+// spaces.
+#define LZSS_WINDOW_START 4078
+
+static int lzss_decode_fast_mem_to_buf(const unsigned char* in, unsigned char* dest, unsigned int length);
+static void lzss_check_mem_to_buf(const unsigned char* in, const unsigned char* dest, unsigned int length, int decoded);
+static int lzss_decode_ring_mem_to_buf(const unsigned char* in, unsigned char* dest, unsigned int length);
+static int lzss_decode_buffered_to_buf(FILE* in, unsigned char* dest, unsigned int length);
+static inline bool lzss_copy_match(unsigned char* dest, unsigned char** curr, const unsigned char* in);
 static inline void lzss_fill_decode_buffer(FILE* stream);
 static inline void lzss_decode_chunk_to_buf(unsigned int type, unsigned char** dest, unsigned int* length);
 static inline void lzss_decode_chunk_to_file(unsigned int type, FILE* stream, unsigned int* length);
@@ -31,8 +45,256 @@ static unsigned char* decode_buffer_end;
 // 0x6B0C70
 static unsigned char ring_buffer[4116];
 
+// When enabled every [lzss_decode_mem_to_buf] result is compared against
+// ring buffer decoder, see [lzss_enable_check].
+static bool lzss_check = false;
+
+// Number of bytes decoded by [lzss_decode_mem_to_buf].
+static unsigned int lzss_mem_decoded = 0;
+
+// Number of [lzss_decode_mem_to_buf] calls which fell back to ring buffer.
+static int lzss_mem_fallbacks = 0;
+
+// Number of [lzss_decode_mem_to_buf] results checked and found different
+// when [lzss_check] is enabled.
+static int lzss_checked = 0;
+static int lzss_mismatches = 0;
+
+// Number of consecutive literals (set bits starting from the lowest one) in
+// every flag byte.
+static const unsigned char lzss_literal_run[256] = {
+    0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 4,
+    0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 5,
+    0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 4,
+    0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 6,
+    0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 4,
+    0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 5,
+    0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 4,
+    0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 7,
+    0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 4,
+    0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 5,
+    0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 4,
+    0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 6,
+    0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 4,
+    0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 5,
+    0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 4,
+    0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 8,
+};
+
 // 0x4CA260
 int lzss_decode_to_buf(FILE* in, unsigned char* dest, unsigned int length)
+{
+    decode_buffer_end = decode_buffer;
+    decode_buffer_position = decode_buffer;
+    decode_bytes_left = length;
+
+    return lzss_decode_buffered_to_buf(in, dest, length);
+}
+
+// Decodes [length] bytes of compressed data which is already in memory.
+int lzss_decode_mem_to_buf(const unsigned char* in, unsigned char* dest, unsigned int length)
+{
+    int decoded = lzss_decode_fast_mem_to_buf(in, dest, length);
+
+    lzss_mem_decoded += decoded;
+
+    if (lzss_check) {
+        lzss_check_mem_to_buf(in, dest, length, decoded);
+    }
+
+    return decoded;
+}
+
+// Enables comparing output of [lzss_decode_mem_to_buf] against ring buffer
+// decoder (which reads from files) on every call.
+void lzss_enable_check()
+{
+    lzss_check = true;
+}
+
+// Prints number of bytes decoded from memory, number of fallbacks to ring
+// buffer and check results into [dest].
+bool lzss_stats(char* dest)
+{
+    if (dest == NULL) {
+        return false;
+    }
+
+    sprintf(dest, "LZSS: %u bytes decoded from memory, %d fallbacks, %d checked, %d mismatches.\n", lzss_mem_decoded, lzss_mem_fallbacks, lzss_checked, lzss_mismatches);
+
+    return true;
+}
+
+// Since [dest] is contiguous, matches are copied from previously decoded
+// output instead of ring buffer, and runs of literals are copied at once.
+static int lzss_decode_fast_mem_to_buf(const unsigned char* in, unsigned char* dest, unsigned int length)
+{
+    const unsigned char* start;
+    const unsigned char* end;
+    unsigned char* curr;
+    unsigned int flags;
+    int bits;
+    int run;
+
+    start = in;
+    end = in + length;
+    curr = dest;
+
+    while (end - in > 16) {
+        flags = *in++;
+        bits = 8;
+
+        while (true) {
+            run = lzss_literal_run[flags];
+            if (run != 0) {
+                memcpy(curr, in, run);
+                curr += run;
+                in += run;
+
+                bits -= run;
+                if (bits == 0) {
+                    break;
+                }
+
+                flags >>= run;
+            }
+
+            if (!lzss_copy_match(dest, &curr, in)) {
+                lzss_mem_fallbacks++;
+                return lzss_decode_ring_mem_to_buf(start, dest, length);
+            }
+
+            in += 2;
+
+            bits -= 1;
+            if (bits == 0) {
+                break;
+            }
+
+            flags >>= 1;
+        }
+    }
+
+    while (in < end) {
+        flags = *in++;
+
+        for (bits = 0; bits < 8 && in < end; bits++) {
+            if ((flags & 0x01) != 0) {
+                *curr++ = *in++;
+            } else {
+                if (!lzss_copy_match(dest, &curr, in)) {
+                    lzss_mem_fallbacks++;
+                    return lzss_decode_ring_mem_to_buf(start, dest, length);
+                }
+
+                in += 2;
+            }
+
+            flags >>= 1;
+        }
+    }
+
+    return curr - dest;
+}
+
+// Copies match described by two bytes at [in] from output decoded so far.
+//
+// Returns `false` if match refers to part of sliding window which is not
+// initialized by decoder (which is never the case for well-formed data), so
+// that caller can fall back to decoding via ring buffer.
+static inline bool lzss_copy_match(unsigned char* dest, unsigned char** curr, const unsigned char* in)
+{
+    unsigned int offset;
+    unsigned int count;
+    unsigned int pos;
+    unsigned int distance;
+    unsigned int spaces;
+    unsigned char* src;
+    unsigned int index;
+
+    offset = in[0] | ((in[1] & 0xF0) << 4);
+    count = (in[1] & 0x0F) + 3;
+
+    pos = *curr - dest;
+    distance = (LZSS_WINDOW_START + pos - offset) & (LZSS_WINDOW_SIZE - 1);
+    if (distance == 0) {
+        distance = LZSS_WINDOW_SIZE;
+    }
+
+    if (distance > pos) {
+        if (distance > pos + LZSS_WINDOW_START) {
+            return false;
+        }
+
+        // Match starts in initial part of window filled with spaces.
+        spaces = distance - pos;
+        if (spaces > count) {
+            spaces = count;
+        }
+
+        memset(*curr, ' ', spaces);
+        *curr += spaces;
+        count -= spaces;
+    }
+
+    src = *curr - distance;
+    if (distance >= count) {
+        memcpy(*curr, src, count);
+    } else {
+        // Overlapping match repeats last [distance] bytes.
+        for (index = 0; index < count; index++) {
+            (*curr)[index] = src[index];
+        }
+    }
+
+    *curr += count;
+
+    return true;
+}
+
+// Decodes [length] bytes at [in] once more via ring buffer and compares the
+// result with [decoded] bytes at [dest].
+static void lzss_check_mem_to_buf(const unsigned char* in, const unsigned char* dest, unsigned int length, int decoded)
+{
+    // Room for anything ring buffer decoder can produce, even if it differs
+    // from [decoded]. Every two input bytes expand to at most 18.
+    unsigned char* expected = (unsigned char*)malloc(length * 9 + 18);
+    if (expected == NULL) {
+        return;
+    }
+
+    lzss_checked++;
+
+    if (lzss_decode_ring_mem_to_buf(in, expected, length) != decoded
+        || memcmp(expected, dest, decoded) != 0) {
+        lzss_mismatches++;
+    }
+
+    free(expected);
+}
+
+// Decodes [length] bytes of compressed data which is already in memory via
+// ring buffer.
+static int lzss_decode_ring_mem_to_buf(const unsigned char* in, unsigned char* dest, unsigned int length)
+{
+    int rc;
+
+    // Point decode buffer directly to input, there is nothing left for
+    // [lzss_fill_decode_buffer] to read.
+    decode_buffer_position = (unsigned char*)in;
+    decode_bytes_left = 0;
+
+    rc = lzss_decode_buffered_to_buf(NULL, dest, length);
+
+    decode_buffer_end = decode_buffer;
+    decode_buffer_position = decode_buffer;
+
+    return rc;
+}
+
+// Decodes [length] bytes starting at [decode_buffer_position] refilling
+// decode buffer from [in] as needed.
+static int lzss_decode_buffered_to_buf(FILE* in, unsigned char* dest, unsigned int length)
 {
     unsigned char* curr;
     unsigned char byte;
@@ -40,9 +302,6 @@ int lzss_decode_to_buf(FILE* in, unsigned char* dest, unsigned int length)
     curr = dest;
     memset(ring_buffer, ' ', 4078);
     ring_buffer_index = 4078;
-    decode_buffer_end = decode_buffer;
-    decode_buffer_position = decode_buffer;
-    decode_bytes_left = length;
 
     while (length > 16) {
         lzss_fill_decode_buffer(in);
@@ -1,9 +1,13 @@
 #ifndef FALLOUT_PLIB_DB_LZSS_H_
 #define FALLOUT_PLIB_DB_LZSS_H_
 
+#include <stdbool.h>
 #include <stdio.h>
 
 int lzss_decode_to_buf(FILE* in, unsigned char* dest, unsigned int length);
+int lzss_decode_mem_to_buf(const unsigned char* in, unsigned char* dest, unsigned int length);
+void lzss_enable_check();
+bool lzss_stats(char* dest);
 void lzss_decode_to_file(FILE* in, FILE* out, unsigned int length);
 
 #endif /* FALLOUT_PLIB_DB_LZSS_H_ */
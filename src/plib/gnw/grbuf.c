@@ -236,22 +236,7 @@ void trans_buf_to_buf(unsigned char* src, int width, int height, int srcPitch, u
 // 0x4BDFC4
 void mask_buf_to_buf(unsigned char* src, int width, int height, int srcPitch, unsigned char* mask, int maskPitch, unsigned char* dest, int destPitch)
 {
-    int y;
-    int x;
-
-    for (y = 0; y < height; y++) {
-        for (x = 0; x < width; x++) {
-            if (*mask != 0) {
-                *dest = *src;
-            }
-            src++;
-            mask++;
-            dest++;
-        }
-        src += srcPitch - width;
-        mask += maskPitch - width;
-        dest += destPitch - width;
-    }
+    maskSrcCopy(dest, destPitch, src, srcPitch, mask, maskPitch, width, height);
 }
 
 // 0x4BE10C
@@ -52,6 +52,11 @@ static IdleFunc* idle_func = NULL;
 // 0x539D70
 static FocusFunc* focus_func = NULL;
 
+// Called before and after each pass over background processes, see
+// [set_bk_frame_funcs].
+static BackgroundProcess* bk_frame_start_func = NULL;
+static BackgroundProcess* bk_frame_end_func = NULL;
+
 // 0x539D74
 static unsigned int GNW95_repeat_rate = 80;
 
@@ -314,6 +319,10 @@ void GNW_do_bk_process()
 
     bk_process_time = get_time();
 
+    if (bk_frame_start_func != NULL) {
+        bk_frame_start_func();
+    }
+
     FuncPtr curr = bk_list;
     FuncPtr* currPtr = &(bk_list);
 
@@ -329,6 +338,18 @@ void GNW_do_bk_process()
         }
         curr = next;
     }
+
+    if (bk_frame_end_func != NULL) {
+        bk_frame_end_func();
+    }
+}
+
+// Registers functions called before and after every pass over background
+// processes, so that work they produce within one frame can be batched.
+void set_bk_frame_funcs(BackgroundProcess* start_func, BackgroundProcess* end_func)
+{
+    bk_frame_start_func = start_func;
+    bk_frame_end_func = end_func;
 }
 
 // 0x4B35BC
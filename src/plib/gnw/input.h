@@ -25,6 +25,7 @@ void flush_input_buffer();
 void GNW_do_bk_process();
 void add_bk_process(BackgroundProcess* f);
 void remove_bk_process(BackgroundProcess* f);
+void set_bk_frame_funcs(BackgroundProcess* start_func, BackgroundProcess* end_func);
 void enable_bk();
 void disable_bk();
 void register_pause(int new_pause_key, PauseWinFunc* new_pause_win_func);
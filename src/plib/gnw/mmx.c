@@ -1,9 +1,18 @@
 #include "plib/gnw/mmx.h"
 
+#include <emmintrin.h>
 #include <string.h>
 
 #include "plib/gnw/svga.h"
 
+// Pitch of buffers used by [sse2SelfTest], wide enough for widths with two
+// full SSE2 blocks, a partial one and unaligned start.
+#define SSE2_TEST_PITCH 48
+#define SSE2_TEST_HEIGHT 5
+
+static void transSrcCopySSE2(unsigned char* dest, int destPitch, unsigned char* src, int srcPitch, int width, int height);
+static void maskSrcCopySSE2(unsigned char* dest, int destPitch, unsigned char* src, int srcPitch, unsigned char* mask, int maskPitch, int width, int height);
+
 // Return `true` if CPU supports MMX.
 //
 // 0x4CD640
@@ -24,6 +33,85 @@ bool mmxTest()
     return v1 != 0;
 }
 
+// Return `true` if CPU supports SSE2.
+bool sse2Test()
+{
+    int v1;
+
+    __asm
+    {
+        mov eax, 1
+        cpuid
+        and edx, 0x4000000
+        mov v1, edx
+    }
+
+    return v1 != 0;
+}
+
+// Returns `true` if SSE2 blits produce the same pixels as plain ones.
+//
+// Runs both on synthetic buffers with every width up to two full blocks and
+// a partial one, at unaligned offsets, with fully transparent, fully opaque
+// and mixed blocks.
+bool sse2SelfTest()
+{
+    unsigned char src[SSE2_TEST_PITCH * SSE2_TEST_HEIGHT];
+    unsigned char mask[SSE2_TEST_PITCH * SSE2_TEST_HEIGHT];
+    unsigned char dest[SSE2_TEST_PITCH * SSE2_TEST_HEIGHT];
+    unsigned char expected[SSE2_TEST_PITCH * SSE2_TEST_HEIGHT];
+
+    unsigned int seed = 0x12345678;
+    for (int index = 0; index < SSE2_TEST_PITCH * SSE2_TEST_HEIGHT; index++) {
+        seed = seed * 1103515245 + 12345;
+
+        // Rows alternate between transparent, opaque and mixed runs.
+        int row = index / SSE2_TEST_PITCH;
+        int value = (seed >> 16) & 0xFF;
+        if (row % 3 == 0) {
+            value = (index % SSE2_TEST_PITCH) < 20 ? 0 : value;
+        } else if (row % 3 == 1) {
+            value |= 1;
+        } else if ((seed >> 8) & 1) {
+            value = 0;
+        }
+
+        src[index] = (unsigned char)value;
+        mask[index] = (unsigned char)(((seed >> 24) & 3) == 0 ? 0 : (seed >> 24));
+    }
+
+    bool oldSse2Enabled = sse2Enabled;
+    bool result = true;
+
+    for (int offset = 0; offset < 3 && result; offset++) {
+        for (int width = 1; offset + width <= SSE2_TEST_PITCH - 3 && result; width++) {
+            for (int masked = 0; masked < 2 && result; masked++) {
+                for (int index = 0; index < SSE2_TEST_PITCH * SSE2_TEST_HEIGHT; index++) {
+                    expected[index] = (unsigned char)(index * 7);
+                    dest[index] = expected[index];
+                }
+
+                sse2Enabled = false;
+
+                // Source, mask and destination are misaligned with each other.
+                if (masked) {
+                    maskSrcCopy(expected + offset, SSE2_TEST_PITCH, src + 3 - offset, SSE2_TEST_PITCH, mask + 1, SSE2_TEST_PITCH, width, SSE2_TEST_HEIGHT);
+                    maskSrcCopySSE2(dest + offset, SSE2_TEST_PITCH, src + 3 - offset, SSE2_TEST_PITCH, mask + 1, SSE2_TEST_PITCH, width, SSE2_TEST_HEIGHT);
+                } else {
+                    transSrcCopy(expected + offset, SSE2_TEST_PITCH, src + 3 - offset, SSE2_TEST_PITCH, width, SSE2_TEST_HEIGHT);
+                    transSrcCopySSE2(dest + offset, SSE2_TEST_PITCH, src + 3 - offset, SSE2_TEST_PITCH, width, SSE2_TEST_HEIGHT);
+                }
+
+                result = memcmp(dest, expected, sizeof(dest)) == 0;
+            }
+        }
+    }
+
+    sse2Enabled = oldSse2Enabled;
+
+    return result;
+}
+
 // 0x4CDB50
 void srcCopy(unsigned char* dest, int destPitch, unsigned char* src, int srcPitch, int width, int height)
 {
@@ -44,7 +132,9 @@ void srcCopy(unsigned char* dest, int destPitch, unsigned char* src, int srcPitc
 // 0x4CDC75
 void transSrcCopy(unsigned char* dest, int destPitch, unsigned char* src, int srcPitch, int width, int height)
 {
-    if (mmxEnabled) {
+    if (sse2Enabled) {
+        transSrcCopySSE2(dest, destPitch, src, srcPitch, width, height);
+    } else if (mmxEnabled) {
         // TODO: Blit with MMX.
         mmxEnabled = false;
         transSrcCopy(dest, destPitch, src, srcPitch, width, height);
@@ -66,3 +156,105 @@ void transSrcCopy(unsigned char* dest, int destPitch, unsigned char* src, int sr
         }
     }
 }
+
+// Copies pixels of [src] whose [mask] pixel is non-zero.
+void maskSrcCopy(unsigned char* dest, int destPitch, unsigned char* src, int srcPitch, unsigned char* mask, int maskPitch, int width, int height)
+{
+    if (sse2Enabled) {
+        maskSrcCopySSE2(dest, destPitch, src, srcPitch, mask, maskPitch, width, height);
+    } else {
+        int destSkip = destPitch - width;
+        int srcSkip = srcPitch - width;
+        int maskSkip = maskPitch - width;
+
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                if (*mask != 0) {
+                    *dest = *src;
+                }
+                src++;
+                mask++;
+                dest++;
+            }
+            src += srcSkip;
+            mask += maskSkip;
+            dest += destSkip;
+        }
+    }
+}
+
+// Processes 16 pixels at a time: pixels where [src] is 0 keep [dest] value
+// selected with compare mask, blocks which are fully transparent are not
+// written at all.
+static void transSrcCopySSE2(unsigned char* dest, int destPitch, unsigned char* src, int srcPitch, int width, int height)
+{
+    __m128i zero = _mm_setzero_si128();
+
+    for (int y = 0; y < height; y++) {
+        int x = 0;
+
+        for (; x + 16 <= width; x += 16) {
+            __m128i c = _mm_loadu_si128((__m128i*)(src + x));
+            __m128i transparent = _mm_cmpeq_epi8(c, zero);
+            int bits = _mm_movemask_epi8(transparent);
+            if (bits == 0xFFFF) {
+                continue;
+            }
+
+            if (bits == 0) {
+                _mm_storeu_si128((__m128i*)(dest + x), c);
+            } else {
+                __m128i d = _mm_loadu_si128((__m128i*)(dest + x));
+                d = _mm_or_si128(_mm_and_si128(transparent, d), _mm_andnot_si128(transparent, c));
+                _mm_storeu_si128((__m128i*)(dest + x), d);
+            }
+        }
+
+        for (; x < width; x++) {
+            unsigned char c = src[x];
+            if (c != 0) {
+                dest[x] = c;
+            }
+        }
+
+        src += srcPitch;
+        dest += destPitch;
+    }
+}
+
+// Same as [transSrcCopySSE2], but transparency is taken from [mask].
+static void maskSrcCopySSE2(unsigned char* dest, int destPitch, unsigned char* src, int srcPitch, unsigned char* mask, int maskPitch, int width, int height)
+{
+    __m128i zero = _mm_setzero_si128();
+
+    for (int y = 0; y < height; y++) {
+        int x = 0;
+
+        for (; x + 16 <= width; x += 16) {
+            __m128i transparent = _mm_cmpeq_epi8(_mm_loadu_si128((__m128i*)(mask + x)), zero);
+            int bits = _mm_movemask_epi8(transparent);
+            if (bits == 0xFFFF) {
+                continue;
+            }
+
+            __m128i c = _mm_loadu_si128((__m128i*)(src + x));
+            if (bits == 0) {
+                _mm_storeu_si128((__m128i*)(dest + x), c);
+            } else {
+                __m128i d = _mm_loadu_si128((__m128i*)(dest + x));
+                d = _mm_or_si128(_mm_and_si128(transparent, d), _mm_andnot_si128(transparent, c));
+                _mm_storeu_si128((__m128i*)(dest + x), d);
+            }
+        }
+
+        for (; x < width; x++) {
+            if (mask[x] != 0) {
+                dest[x] = src[x];
+            }
+        }
+
+        src += srcPitch;
+        mask += maskPitch;
+        dest += destPitch;
+    }
+}
@@ -4,7 +4,10 @@
 #include <stdbool.h>
 
 bool mmxTest();
+bool sse2Test();
+bool sse2SelfTest();
 void srcCopy(unsigned char* dest, int destPitch, unsigned char* src, int srcPitch, int width, int height);
 void transSrcCopy(unsigned char* dest, int destPitch, unsigned char* src, int srcPitch, int width, int height);
+void maskSrcCopy(unsigned char* dest, int destPitch, unsigned char* src, int srcPitch, unsigned char* mask, int maskPitch, int width, int height);
 
 #endif /* MMX_H */
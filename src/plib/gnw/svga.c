@@ -1,5 +1,6 @@
 #include "plib/gnw/svga.h"
 
+#include "plib/gnw/debug.h"
 #include "plib/gnw/gnw.h"
 #include "plib/gnw/grbuf.h"
 #include "plib/gnw/mmx.h"
@@ -28,6 +29,9 @@ UpdatePaletteFunc* update_palette_func = NULL;
 // 0x51E2C8
 bool mmxEnabled = true;
 
+// Enabled by [mmxEnable] when CPU supports SSE2.
+bool sse2Enabled = false;
+
 // 0x6AC7F0
 unsigned short GNW95_Pal16[256];
 
@@ -64,14 +68,25 @@ void mmxEnable(bool enable)
     // 0x6ACA20
     static bool mmx;
 
+    static bool sse2;
+
     if (!inited) {
         mmx = mmxTest();
+        sse2 = sse2Test();
+        if (sse2 && !sse2SelfTest()) {
+            debug_printf("mmxEnable: SSE2 blits do not match plain ones, SSE2 disabled.\n");
+            sse2 = false;
+        }
         inited = true;
     }
 
     if (mmx) {
         mmxEnabled = enable;
     }
+
+    if (sse2) {
+        sse2Enabled = enable;
+    }
 }
 
 // 0x4CAD08
@@ -13,6 +13,7 @@ extern LPDIRECTDRAWSURFACE GNW95_DDRestoreSurface;
 extern LPDIRECTDRAWPALETTE GNW95_DDPrimaryPalette;
 extern UpdatePaletteFunc* update_palette_func;
 extern bool mmxEnabled;
+extern bool sse2Enabled;
 
 extern unsigned short GNW95_Pal16[256];
 extern Rect scr_size;